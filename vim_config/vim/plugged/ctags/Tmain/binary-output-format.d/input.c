@@ -0,0 +1,22 @@
+struct point {
+	int x;
+	int y;
+};
+
+struct Point {
+	double x;
+	double y;
+};
+
+static int counter;
+
+int main (void)
+{
+	return counter;
+}
+
+#ifdef USE_X
+int x (void) { return 0; }
+#else
+int x (void) { return 1; }
+#endif
@@ -0,0 +1,38 @@
+# Copyright: 2026 Universal Ctags Team
+# License: GPL-2
+
+CTAGS=$1
+BUILDDIR=$2
+READTAGS=$3
+
+. ../utils.sh
+
+if ! [ -x "${READTAGS}" ]; then
+	skip "no readtags"
+fi
+
+O="--quiet --options=NONE --pseudo-tags=TAG_FILE_SORTED --fields=+nS"
+T=$BUILDDIR/binary-output-format.tags
+B=$BUILDDIR/binary-output-format.tags.bin
+
+rm -f $T $B
+
+for sort in yes foldcase no; do
+	${CTAGS} $O --sort=$sort -o $T input.c &&
+	${CTAGS} $O --sort=$sort --output-format=binary -o $B input.c || exit 1
+
+	echo "# sort=$sort"
+	for t in $T $B; do
+		${READTAGS} -t $t -e -l > $t.out
+		${READTAGS} -t $t -e - x >> $t.out
+		${READTAGS} -t $t -e -i - POINT >> $t.out
+		${READTAGS} -t $t -e -p - c >> $t.out
+		${READTAGS} -t $t -e -i -p - P >> $t.out
+		${READTAGS} -t $t -D >> $t.out
+	done
+	if cmp $T.out $B.out; then
+		cat $B.out
+	fi
+done
+
+rm -f $T $B $T.out $B.out
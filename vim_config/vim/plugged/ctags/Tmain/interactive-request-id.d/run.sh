@@ -0,0 +1,31 @@
+# Copyright: 2026 Universal Ctags Team
+# License: GPL-2
+
+CTAGS=$1
+. ../utils.sh
+
+is_feature_available ${CTAGS} interactive
+
+# It seems that the output format is slightly different between libjansson versions
+s()
+{
+	sed -e s/':"'/': "'/g
+}
+
+CTAGS="$CTAGS --options=NONE"
+
+echo request ids are echoed in completed responses
+echo =======================================
+size=$(filesize test.rb)
+(
+  echo '{"command":"generate-tags", "filename":"test.rb", "id":1}'
+  echo '{"command":"generate-tags", "filename":"foobar.rb", "size":'$size', "id":"second"}'
+  cat test.rb
+  echo '{"command":"generate-tags", "filename":"test.rb"}'
+) | ${CTAGS} --_interactive |s
+
+echo
+echo request longer than 1024 bytes
+echo =======================================
+pad=$(printf '%2048s' '')
+echo '{"command":"generate-tags",'"$pad"'"filename":"test.rb", "id":3}' | ${CTAGS} --_interactive |s
@@ -0,0 +1,36 @@
+# Copyright: 2026 Universal Ctags Team
+# License: GPL-2
+
+CTAGS=$1
+BUILDDIR=$2
+. ../utils.sh
+
+is_feature_available ${CTAGS} interactive
+
+# It seems that the output format is slightly different between libjansson versions
+s()
+{
+	sed -e s/':"'/': "'/g
+}
+
+CTAGS="$CTAGS --options=NONE"
+
+request()
+{
+	echo '{"command":"generate-tags", "filename":"'$1'", "size":'$(filesize $2)', "id":'$3'}'
+	cat $2
+}
+
+modified=$BUILDDIR/modified.rb
+sed -e s/foobar/quux/ test.rb > $modified
+
+echo the same buffer twice, a modified buffer, the same buffer under another name
+echo =======================================
+(
+  request test.rb test.rb 1
+  request test.rb test.rb 2
+  request test.rb $modified 3
+  request other.rb test.rb 4
+  request test.rb test.rb 5
+) | ${CTAGS} --_interactive |s
+rm -f $modified
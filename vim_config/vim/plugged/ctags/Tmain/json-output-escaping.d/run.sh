@@ -0,0 +1,15 @@
+# Copyright: 2026 Universal Ctags Team
+# License: GPL-2
+
+CTAGS=$1
+
+. ../utils.sh
+
+is_feature_available "${CTAGS}" json
+
+# A tag whose name is not valid UTF-8 is not printed.
+${CTAGS} --quiet --options=NONE -o - --sort=no \
+		 --output-format=json --fields=+n \
+		 --langdef=ESC --map-ESC=.esc --kinddef-ESC=d,def,definitions \
+		 --regex-ESC='/^def (.*)$/\1/d/' \
+		 input.esc
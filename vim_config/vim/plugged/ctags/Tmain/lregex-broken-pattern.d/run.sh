@@ -0,0 +1,11 @@
+# Copyright: 2026 Universal Ctags Team
+# License: GPL-2
+
+CTAGS=$1
+
+# A pattern that doesn't compile must be reported when it is given,
+# and must not define its kind.
+${CTAGS} --quiet --options=NONE --with-list-header=no \
+	 --langdef=IdealLang --regex-IdealLang='/[a/\0/x,xkind/' \
+	 --regex-IdealLang='/def (.*)/\1/d,definition/' \
+	 --list-kinds-full=IdealLang
@@ -0,0 +1,7 @@
+# Copyright: 2026 Universal Ctags Team
+# License: GPL-2
+
+CTAGS=$1
+
+${CTAGS} --quiet --options=NONE --totals=profile -o /dev/null input.c 2>&1 \
+	| sed -E 's/[0-9]+\.[0-9]+/N/g'
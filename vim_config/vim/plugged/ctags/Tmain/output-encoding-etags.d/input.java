@@ -0,0 +1,4 @@
+class Foo { // Fooクラス
+	public Foo() { // コンストラクタ
+	}
+}
@@ -0,0 +1,20 @@
+#!/bin/sh
+# Copyright: 2026 Universal Ctags Team
+# License: GPL-2
+
+CTAGS=$1
+BUILDDIR=$2
+
+. ../utils.sh
+
+# Each line must be converted once, and the byte count of the
+# section must be the one of the converted lines.
+if ${CTAGS} --quiet --options=NONE --list-features | grep -q iconv; then
+	${CTAGS} --quiet --options=NONE -e \
+			 --output-encoding=shift_jis --input-encoding=utf-8 \
+			 -o - \
+			 input.java
+	exit $?
+else
+	skip "iconv feature is not available"
+fi
@@ -0,0 +1,20 @@
+#!/bin/sh
+# Copyright: 2026 Universal Ctags Team
+# License: GPL-2
+
+CTAGS=$1
+BUILDDIR=$2
+
+. ../utils.sh
+
+# ISO-2022-JP switches character sets with 7-bit escape sequences.
+# A line made only of 7-bit bytes must still be converted.
+if ${CTAGS} --quiet --options=NONE --list-features | grep -q iconv; then
+	${CTAGS} --quiet --options=NONE \
+			 --input-encoding=ISO-2022-JP --output-encoding=UTF-8 \
+			 -o - \
+			 input.md
+	exit $?
+else
+	skip "iconv feature is not available"
+fi
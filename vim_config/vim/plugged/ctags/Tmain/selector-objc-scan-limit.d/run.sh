@@ -0,0 +1,19 @@
+# Copyright: 2026 Universal Ctags Team
+# License: GPL-2
+
+CTAGS=$1
+BUILDDIR=$2
+
+# The ObjectiveC selector for .h files looks for its markers
+# only in the first 64KB of the input.
+decls()
+{
+	awk -v n=$1 'BEGIN { for (i = 0; i < n; i++) printf "extern int f%d (int a, int b);\n", i }'
+}
+
+{ echo '@interface Foo'; decls 4000; echo '@end'; } > $BUILDDIR/early.h
+{ decls 4000; echo '@interface Foo'; echo '@end'; } > $BUILDDIR/late.h
+
+cd $BUILDDIR
+${CTAGS} --quiet --options=NONE --print-language early.h late.h
+rm -f early.h late.h
@@ -0,0 +1,2 @@
+int foo;
+int bar(void){return 0;}
@@ -0,0 +1,7 @@
+# Copyright: 2026 Universal Ctags Team
+# License: GPL-2
+
+CTAGS=$1
+
+# An empty format falls back to the default xref format.
+${CTAGS} --quiet --options=NONE -x --_xformat= input.c
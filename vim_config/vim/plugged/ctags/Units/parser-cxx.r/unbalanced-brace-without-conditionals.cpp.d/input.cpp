@@ -0,0 +1,9 @@
+// The braces are not balanced, and there is no conditional
+// branch the preprocessor could choose differently: a second
+// pass would fail in the same way.
+int a;
+struct S { int x; };
+void f() {
+	if (1) {
+}
+int g() { return 0; }
@@ -0,0 +1,15 @@
+#!/usr/bin/env kotlin
+@file:JvmName("Foo")
+package a.b
+
+import x.y.Z
+
+class C {
+    fun f() {}
+}
+
+// Only the header at the top of the file names the package.
+package x.y
+import q.R
+
+class D
@@ -23,6 +23,17 @@
 */
 #define TAB '\t'
 
+/* Layout of a tag file in the binary format. See main/writer-binary.c
+ * of Universal Ctags for details. */
+#define BINARY_MAGIC        "!_TAGBIN"
+#define BINARY_MAGIC_LENGTH 8
+#define BINARY_VERSION      1
+#define BINARY_HEADER_SIZE  (BINARY_MAGIC_LENGTH + 4 * 2 + 4 * 2 * BINARY_SECTIONS)
+#define BINARY_RECORD_SIZE  (4 * 8)
+#define BINARY_FIELD_SIZE   (4 * 2)
+
+#define BINARY_FLAG_FILE_SCOPE 0x1
+
 
 /*
 *   DATA DECLARATIONS
@@ -32,6 +43,33 @@ typedef struct {
 	char *buffer;
 } vstring;
 
+enum eBinarySection {
+	BINARY_STRINGS,
+	BINARY_PTAGS,
+	BINARY_TAGS,
+	BINARY_FIELDS,
+	BINARY_INDEX,
+	BINARY_FINDEX,
+	BINARY_SECTIONS,
+};
+
+/* Image of a tag file in the binary format */
+typedef struct {
+		/* whole contents of the tag file */
+	unsigned char *image;
+		/* offset and number of elements of each section */
+	unsigned long offset [BINARY_SECTIONS];
+	unsigned long count [BINARY_SECTIONS];
+		/* next tag record returned from tagsNext() */
+	unsigned long next;
+		/* next pseudo tag record returned from tagsNextPseudoTag() */
+	unsigned long nextPseudo;
+		/* position in the index of the last match */
+	unsigned long match;
+		/* index used in the last search */
+	enum eBinarySection index;
+} binaryImage;
+
 /* Information about current tag file */
 struct sTagFile {
 		/* has the file been opened and this structure initialized? */
@@ -84,6 +122,8 @@ struct sTagFile {
 		/* 0 (initial state set by calloc), errno value,
 		 * or tagErrno typed value */
 	int err;
+		/* non-NULL if the tag file is in the binary format */
+	binaryImage *binary;
 };
 
 /*
@@ -778,6 +818,292 @@ static tagResult gotoFirstLogicalTag (tagFile *const file)
 	return TagSuccess;
 }
 
+/*
+*   Binary tag file
+*/
+
+static unsigned long readUint32 (const unsigned char *p)
+{
+	return (unsigned long) p [0]
+		| ((unsigned long) p [1] << 8)
+		| ((unsigned long) p [2] << 16)
+		| ((unsigned long) p [3] << 24);
+}
+
+static int isBinaryTagFile (FILE *fp)
+{
+	char magic [BINARY_MAGIC_LENGTH];
+	int r = (fread (magic, 1, BINARY_MAGIC_LENGTH, fp) == BINARY_MAGIC_LENGTH
+			 && memcmp (magic, BINARY_MAGIC, BINARY_MAGIC_LENGTH) == 0);
+	rewind (fp);
+	return r;
+}
+
+static const char *binaryString (const binaryImage *const bin, unsigned long offset)
+{
+	if (offset >= bin->count [BINARY_STRINGS])
+		offset = 0;
+	return (const char *) bin->image + bin->offset [BINARY_STRINGS] + offset;
+}
+
+static const unsigned char *binaryRecord (const binaryImage *const bin,
+										  enum eBinarySection section,
+										  unsigned long n)
+{
+	return bin->image + bin->offset [section] + n * BINARY_RECORD_SIZE;
+}
+
+static const char *binaryRecordName (const binaryImage *const bin,
+									 unsigned long n)
+{
+	return binaryString (bin, readUint32 (binaryRecord (bin, BINARY_TAGS, n)));
+}
+
+static tagResult loadBinaryImage (tagFile *const file, tagFileInfo *const info)
+{
+	binaryImage *bin = (binaryImage *) calloc (1, sizeof (binaryImage));
+	const unsigned char *header;
+	static const size_t elementSize [BINARY_SECTIONS] = {
+		[BINARY_STRINGS] = 1,
+		[BINARY_PTAGS]   = BINARY_RECORD_SIZE,
+		[BINARY_TAGS]    = BINARY_RECORD_SIZE,
+		[BINARY_FIELDS]  = BINARY_FIELD_SIZE,
+		[BINARY_INDEX]   = 4,
+		[BINARY_FINDEX]  = 4,
+	};
+	unsigned long sort;
+	unsigned long i;
+
+	if (bin == NULL)
+	{
+		info->status.error_number = ENOMEM;
+		return TagFailure;
+	}
+	file->binary = bin;
+
+	if (file->size < BINARY_HEADER_SIZE)
+		goto format_error;
+	bin->image = (unsigned char *) malloc ((size_t) file->size);
+	if (bin->image == NULL)
+	{
+		info->status.error_number = ENOMEM;
+		return TagFailure;
+	}
+	if (fread (bin->image, 1, (size_t) file->size, file->fp) != (size_t) file->size)
+	{
+		info->status.error_number = ferror (file->fp)? errno: TagErrnoUnexpectedFormat;
+		return TagFailure;
+	}
+
+	header = bin->image + BINARY_MAGIC_LENGTH;
+	if (readUint32 (header) != BINARY_VERSION)
+		goto format_error;
+	sort = readUint32 (header + 4);
+	if (sort > TAG_FOLDSORTED)
+	{
+		info->status.error_number = TagErrnoUnexpectedSortedMethod;
+		return TagFailure;
+	}
+	for (i = 0; i < BINARY_SECTIONS; i++)
+	{
+		bin->offset [i] = readUint32 (header + 8 + 8 * i);
+		bin->count [i] = readUint32 (header + 8 + 8 * i + 4);
+		if (bin->offset [i] > (unsigned long) file->size
+			|| bin->count [i] > ((unsigned long) file->size - bin->offset [i]) / elementSize [i])
+			goto format_error;
+	}
+	/* Offset 0 is for the empty string, and the last string must be
+	 * terminated. */
+	if (bin->count [BINARY_STRINGS] == 0
+		|| bin->image [bin->offset [BINARY_STRINGS]] != '\0'
+		|| bin->image [bin->offset [BINARY_STRINGS] + bin->count [BINARY_STRINGS] - 1] != '\0'
+		|| bin->count [BINARY_INDEX] != bin->count [BINARY_TAGS]
+		|| bin->count [BINARY_FINDEX] != bin->count [BINARY_TAGS])
+		goto format_error;
+	for (i = 0; i < bin->count [BINARY_TAGS]; i++)
+		if (readUint32 (bin->image + bin->offset [BINARY_INDEX] + 4 * i) >= bin->count [BINARY_TAGS]
+			|| readUint32 (bin->image + bin->offset [BINARY_FINDEX] + 4 * i) >= bin->count [BINARY_TAGS])
+			goto format_error;
+
+	file->format = 2;
+	file->sortMethod = (tagSortType) sort;
+	info->file.format = file->format;
+	info->file.sort = file->sortMethod;
+	info->program.author = NULL;
+	info->program.name = NULL;
+	info->program.url = NULL;
+	info->program.version = NULL;
+
+	for (i = 0; i < bin->count [BINARY_PTAGS]; i++)
+	{
+		const unsigned char *r = binaryRecord (bin, BINARY_PTAGS, i);
+		const char *key = binaryString (bin, readUint32 (r));
+		const char *value = binaryString (bin, readUint32 (r + 4));
+		char **dest = NULL;
+
+		if (strncmp (key, PseudoTagPrefix, PseudoTagPrefixLength) != 0)
+			continue;
+		key += PseudoTagPrefixLength;
+		if (strcmp (key, "TAG_PROGRAM_AUTHOR") == 0)
+			dest = &file->program.author;
+		else if (strcmp (key, "TAG_PROGRAM_NAME") == 0)
+			dest = &file->program.name;
+		else if (strcmp (key, "TAG_PROGRAM_URL") == 0)
+			dest = &file->program.url;
+		else if (strcmp (key, "TAG_PROGRAM_VERSION") == 0)
+			dest = &file->program.version;
+		if (dest && *dest == NULL)
+		{
+			*dest = duplicate (value);
+			if (*dest == NULL)
+			{
+				info->status.error_number = ENOMEM;
+				return TagFailure;
+			}
+		}
+	}
+	info->program.author  = file->program.author;
+	info->program.name    = file->program.name;
+	info->program.url     = file->program.url;
+	info->program.version = file->program.version;
+	info->status.error_number = 0;
+	return TagSuccess;
+
+ format_error:
+	info->status.error_number = TagErrnoUnexpectedFormat;
+	return TagFailure;
+}
+
+static tagResult parseBinaryRecord (tagFile *const file, tagEntry *const entry,
+									const unsigned char *r)
+{
+	const binaryImage *const bin = file->binary;
+	unsigned long kind = readUint32 (r + 16);
+	unsigned long field = readUint32 (r + 24);
+	unsigned long count = readUint32 (r + 28);
+	unsigned long i;
+
+	if (entry == NULL)
+		return TagSuccess;
+
+	memset (entry, 0, sizeof (*entry));
+	entry->name = binaryString (bin, readUint32 (r));
+	entry->file = binaryString (bin, readUint32 (r + 4));
+	entry->address.pattern = binaryString (bin, readUint32 (r + 8));
+	entry->address.lineNumber = readUint32 (r + 12);
+	entry->kind = kind? binaryString (bin, kind): NULL;
+	entry->fileScope = (readUint32 (r + 20) & BINARY_FLAG_FILE_SCOPE)? 1: 0;
+
+	if (field > bin->count [BINARY_FIELDS]
+		|| count > bin->count [BINARY_FIELDS] - field)
+	{
+		file->err = TagErrnoUnexpectedFormat;
+		return TagFailure;
+	}
+	while (count > file->fields.max)
+	{
+		if (growFields (file) != TagSuccess)
+		{
+			file->err = ENOMEM;
+			return TagFailure;
+		}
+	}
+	for (i = 0; i < count; i++)
+	{
+		const unsigned char *f = bin->image + bin->offset [BINARY_FIELDS]
+			+ (field + i) * BINARY_FIELD_SIZE;
+		file->fields.list [i].key = binaryString (bin, readUint32 (f));
+		file->fields.list [i].value = binaryString (bin, readUint32 (f + 4));
+	}
+	entry->fields.count = (unsigned short) count;
+	if (count > 0)
+		entry->fields.list = file->fields.list;
+	return TagSuccess;
+}
+
+/* Names in a binary tag file are not escaped. */
+static int compareBinaryName (tagFile *const file, const char *name)
+{
+	const unsigned char *s1 = (const unsigned char *) file->search.name;
+	const unsigned char *s2 = (const unsigned char *) name;
+	size_t n = file->search.partial? file->search.nameLength: (size_t) -1;
+	int result = 0;
+
+	for (; n > 0; n--, s1++, s2++)
+	{
+		if (file->search.ignorecase)
+			result = toupper (*s1) - toupper (*s2);
+		else
+			result = *s1 - *s2;
+		if (result != 0 || *s1 == '\0')
+			break;
+	}
+	return result;
+}
+
+static unsigned long binaryIndexAt (const binaryImage *const bin, unsigned long i)
+{
+	return readUint32 (bin->image + bin->offset [bin->index] + 4 * i);
+}
+
+static tagResult findBinaryImage (tagFile *const file, tagEntry *const entry)
+{
+	binaryImage *const bin = file->binary;
+	unsigned long lower = 0;
+	unsigned long upper = bin->count [BINARY_TAGS];
+
+	bin->index = file->search.ignorecase? BINARY_FINDEX: BINARY_INDEX;
+
+	/* Look for the first name not less than the name searched for. */
+	while (lower < upper)
+	{
+		unsigned long middle = lower + (upper - lower) / 2;
+		if (compareBinaryName (file,
+							   binaryRecordName (bin, binaryIndexAt (bin, middle))) > 0)
+			lower = middle + 1;
+		else
+			upper = middle;
+	}
+
+	if (lower == bin->count [BINARY_TAGS]
+		|| compareBinaryName (file, binaryRecordName (bin, binaryIndexAt (bin, lower))) != 0)
+	{
+		bin->match = bin->count [BINARY_TAGS];
+		return TagFailure;
+	}
+	bin->match = lower;
+	return parseBinaryRecord (file, entry,
+							  binaryRecord (bin, BINARY_TAGS, binaryIndexAt (bin, lower)));
+}
+
+static tagResult findNextBinaryImage (tagFile *const file, tagEntry *const entry)
+{
+	binaryImage *const bin = file->binary;
+
+	if (bin->match >= bin->count [BINARY_TAGS])
+		return TagFailure;
+	if (++bin->match == bin->count [BINARY_TAGS]
+		|| compareBinaryName (file,
+							  binaryRecordName (bin, binaryIndexAt (bin, bin->match))) != 0)
+	{
+		bin->match = bin->count [BINARY_TAGS];
+		return TagFailure;
+	}
+	return parseBinaryRecord (file, entry,
+							  binaryRecord (bin, BINARY_TAGS, binaryIndexAt (bin, bin->match)));
+}
+
+static tagResult readNextBinaryImage (tagFile *const file, tagEntry *const entry,
+									  enum eBinarySection section,
+									  unsigned long *next)
+{
+	binaryImage *const bin = file->binary;
+
+	if (*next >= bin->count [section])
+		return TagFailure;
+	return parseBinaryRecord (file, entry, binaryRecord (bin, section, (*next)++));
+}
+
 static tagFile *initialize (const char *const filePath, tagFileInfo *const info)
 {
 	tagFile *result = (tagFile*) calloc ((size_t) 1, sizeof (tagFile));
@@ -823,7 +1149,12 @@ static tagFile *initialize (const char *const filePath, tagFileInfo *const info)
 			goto file_error;
 		}
 
-		if (readPseudoTags (result, info) == TagFailure)
+		if (isBinaryTagFile (result->fp))
+		{
+			if (loadBinaryImage (result, info) == TagFailure)
+				goto file_error;
+		}
+		else if (readPseudoTags (result, info) == TagFailure)
 			goto file_error;
 
 		info->status.opened = 1;
@@ -833,6 +1164,15 @@ static tagFile *initialize (const char *const filePath, tagFileInfo *const info)
  mem_error:
 	info->status.error_number = ENOMEM;
  file_error:
+	if (result->binary)
+	{
+		free (result->binary->image);
+		free (result->binary);
+		free (result->program.author);
+		free (result->program.name);
+		free (result->program.url);
+		free (result->program.version);
+	}
 	free (result->line.buffer);
 	free (result->name.buffer);
 	free (result->fields.list);
@@ -847,6 +1187,12 @@ static void terminate (tagFile *const file)
 {
 	fclose (file->fp);
 
+	if (file->binary)
+	{
+		free (file->binary->image);
+		free (file->binary);
+	}
+
 	free (file->line.buffer);
 	free (file->name.buffer);
 	free (file->fields.list);
@@ -1076,6 +1422,8 @@ static tagResult find (tagFile *const file, tagEntry *const entry,
 	file->search.nameLength = strlen (name);
 	file->search.partial = (options & TAG_PARTIALMATCH) != 0;
 	file->search.ignorecase = (options & TAG_IGNORECASE) != 0;
+	if (file->binary)
+		return findBinaryImage (file, entry);
 	if (fseek (file->fp, 0, SEEK_END) < 0)
 	{
 		file->err = errno;
@@ -1147,6 +1495,8 @@ static tagResult findNextFull (tagFile *const file, tagEntry *const entry,
 
 static tagResult findNext (tagFile *const file, tagEntry *const entry)
 {
+	if (file->binary)
+		return findNextBinaryImage (file, entry);
 	return findNextFull (file, entry,
 						 (file->sortMethod == TAG_SORTED      && !file->search.ignorecase) ||
 						 (file->sortMethod == TAG_FOLDSORTED  &&  file->search.ignorecase),
@@ -1161,6 +1511,14 @@ static tagResult findPseudoTag (tagFile *const file, int rewindBeforeFinding, ta
 		return TagFailure;
 	}
 
+	if (file->binary)
+	{
+		if (rewindBeforeFinding)
+			file->binary->nextPseudo = 0;
+		return readNextBinaryImage (file, entry, BINARY_PTAGS,
+									&file->binary->nextPseudo);
+	}
+
 	if (rewindBeforeFinding)
 	{
 		if (fseek(file->fp, 0L, SEEK_SET) == -1)
@@ -1215,6 +1573,12 @@ extern tagResult tagsFirst (tagFile *const file, tagEntry *const entry)
 		return TagFailure;
 	}
 
+	if (file->binary)
+	{
+		file->binary->next = 0;
+		return readNextBinaryImage (file, entry, BINARY_TAGS, &file->binary->next);
+	}
+
 	if (gotoFirstLogicalTag (file) != TagSuccess)
 		return TagFailure;
 	return readNext (file, entry);
@@ -1228,6 +1592,8 @@ extern tagResult tagsNext (tagFile *const file, tagEntry *const entry)
 		return TagFailure;
 	}
 
+	if (file->binary)
+		return readNextBinaryImage (file, entry, BINARY_TAGS, &file->binary->next);
 	return readNext (file, entry);
 }
 
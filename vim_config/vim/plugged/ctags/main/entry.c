@@ -43,11 +43,11 @@
 #include "entry_p.h"
 #include "field.h"
 #include "fmt_p.h"
+#include "htable.h"
 #include "kind.h"
 #include "nestlevel.h"
 #include "options_p.h"
 #include "ptag_p.h"
-#include "rbtree.h"
 #include "read.h"
 #include "read_p.h"
 #include "routines.h"
@@ -55,6 +55,7 @@
 #include "parse_p.h"
 #include "ptrarray.h"
 #include "sort_p.h"
+#include "stats_p.h"
 #include "strlist.h"
 #include "subparser_p.h"
 #include "trashbox.h"
@@ -95,6 +96,8 @@ typedef struct eTagFile {
 	int cork;
 	unsigned int corkFlags;
 	ptrArray *corkQueue;
+	hashTable *corkPaths;	/* input file names shared by the tags in corkQueue */
+	const char *lastCorkPath;
 
 	bool patternCacheValid;
 } tagFile;
@@ -102,8 +105,11 @@ typedef struct eTagFile {
 typedef struct sTagEntryInfoX  {
 	tagEntryInfo slot;
 	int corkIndex;
-	struct rb_root symtab;
-	struct rb_node symnode;
+	hashTable *symtab;	/* name -> entries registered in this scope */
+	/* The full qualified name of this entry as the scope of other
+	   entries. Built on demand, and reused as the prefix of the
+	   names of the entries nested in this one. */
+	char *fqName;
 } tagEntryInfoX;
 
 /*
@@ -119,10 +125,13 @@ static tagFile TagFile = {
     NULL,                /* vLine */
     .cork = false,
     .corkQueue = NULL,
+    .corkPaths = NULL,
+    .lastCorkPath = NULL,
     .patternCacheValid = false,
 };
 
 static bool TagsToStdout = false;
+static vString *TagsToStdoutCapture = NULL;
 
 /*
 *   FUNCTION PROTOTYPES
@@ -359,6 +368,11 @@ static bool isEtagsLine (const char *const line)
 	return result;
 }
 
+static bool isBinaryTagsLine (const char *const line)
+{
+	return strncmp (line, BINARY_TAGS_MAGIC, strlen (BINARY_TAGS_MAGIC)) == 0;
+}
+
 static bool isTagFile (const char *const filename)
 {
 	bool ok = false;  /* we assume not unless confirmed */
@@ -373,7 +387,8 @@ static bool isTagFile (const char *const filename)
 		if (line == NULL)
 			ok = true;
 		else
-			ok = (bool) (isCtagsLine (line) || isEtagsLine (line));
+			ok = (bool) (isCtagsLine (line) || isEtagsLine (line)
+						 || isBinaryTagsLine (line));
 		mio_unref (mio);
 	}
 	return ok;
@@ -433,7 +448,8 @@ extern void openTagFile (void)
 			}
 			else
 			{
-				TagFile.mio = mio_new_file (TagFile.name, "w");
+				TagFile.mio = mio_new_file (TagFile.name,
+											writerProducesBinaryOutput ()? "wb": "w");
 				if (TagFile.mio != NULL && isXtagEnabled (XTAG_PSEUDO_TAGS))
 					addCommonPseudoTags ();
 			}
@@ -537,11 +553,21 @@ static void internalSortTagFile (void)
 }
 #endif
 
+static void copyTagFileToVString (vString *dest)
+{
+	char buf [BUFSIZ];
+	size_t n;
+
+	mio_seek (TagFile.mio, 0, SEEK_SET);
+	while ((n = mio_read (TagFile.mio, buf, 1, sizeof (buf))) > 0)
+		vStringNCatSUnsafe (dest, buf, n);
+}
+
 static void sortTagFile (void)
 {
 	if (TagFile.numTags.added > 0L)
 	{
-		if (Option.sorted != SO_UNSORTED)
+		if (Option.sorted != SO_UNSORTED && !writerProducesBinaryOutput ())
 		{
 			verbose ("sorting tag file\n");
 #ifdef EXTERNAL_SORT
@@ -551,10 +577,19 @@ static void sortTagFile (void)
 #endif
 		}
 		else if (TagsToStdout)
+		{
+			if (TagsToStdoutCapture)
+				copyTagFileToVString (TagsToStdoutCapture);
 			catFile (TagFile.mio);
+		}
 	}
 }
 
+extern void captureTagFileOutput (vString *capture)
+{
+	TagsToStdoutCapture = capture;
+}
+
 static void resizeTagFile (const long newSize)
 {
 	int result;
@@ -611,6 +646,7 @@ extern void closeTagFile (const bool resize)
 
 	if (Option.etags)
 		writeEtagsIncludes (TagFile.mio);
+	writerFinalizeOutput (TagFile.mio);
 	mio_flush (TagFile.mio);
 
 	abort_if_ferror (TagFile.mio);
@@ -629,7 +665,9 @@ extern void closeTagFile (const bool resize)
 				TagFile.name? TagFile.name: "<mio>", size, desiredSize); )
 		resizeTagFile (desiredSize);
 	}
+	profileEnterPhase (PROFILE_SORT);
 	sortTagFile ();
+	profileLeavePhase ();
 	if (TagsToStdout)
 	{
 		if (mio_unref (TagFile.mio) != 0)
@@ -753,54 +791,70 @@ extern size_t truncateTagLineAfterTag (
 	return len;
 }
 
-static char* getFullQualifiedScopeNameFromCorkQueue (const tagEntryInfo * inner_scope)
+/* Skip placeholders; they are not part of the full qualified name. */
+static tagEntryInfoX *getNearestScopeInCorkQueue (tagEntryInfoX *x)
 {
+	while (x && x->slot.placeholder)
+		x = (tagEntryInfoX *)getEntryInCorkQueue (x->slot.extensionFields.scopeIndex);
+	return x;
+}
 
-	int kindIndex = KIND_GHOST_INDEX;
-	langType lang;
-	const tagEntryInfo *scope = inner_scope;
-	const tagEntryInfo *root_scope = NULL;
-	stringList *queue = stringListNew ();
-	vString *v;
+static char *makeFullQualifiedScopeName (const tagEntryInfoX *scope,
+										 const tagEntryInfoX *upper)
+{
 	vString *n;
-	unsigned int c;
 	const char *sep;
 
-	while (scope)
+	if (upper)
 	{
-		if (!scope->placeholder)
-		{
-			if (kindIndex != KIND_GHOST_INDEX)
-			{
-				sep = scopeSeparatorFor (lang, kindIndex, scope->kindIndex);
-				v = vStringNewInit (sep);
-				stringListAdd (queue, v);
-			}
-			/* TODO: scope field of SCOPE can be used for optimization. */
-			v = vStringNewInit (scope->name);
-			stringListAdd (queue, v);
-			kindIndex = scope->kindIndex;
-			lang = scope->langType;
-			root_scope = scope;
-		}
-		scope =  getEntryInCorkQueue (scope->extensionFields.scopeIndex);
+		n = vStringNewInit (upper->fqName);
+		sep = scopeSeparatorFor (scope->slot.langType, scope->slot.kindIndex,
+								 upper->slot.kindIndex);
+	}
+	else
+	{
+		n = vStringNew ();
+		sep = scopeSeparatorFor (scope->slot.langType, scope->slot.kindIndex,
+								 KIND_GHOST_INDEX);
 	}
 
-	n = vStringNew ();
-	sep = root_scope? scopeSeparatorFor (root_scope->langType, root_scope->kindIndex, KIND_GHOST_INDEX): NULL;
 	if (sep)
-		vStringCatS(n, sep);
+		vStringCatS (n, sep);
+	vStringCatS (n, scope->slot.name);
+
+	return vStringDeleteUnwrap (n);
+}
+
+/* The name is built from the cached name of the nearest upper scope,
+ * so each scope entry is visited once however deep it is nested. */
+static const char* getFullQualifiedScopeNameFromCorkQueue (tagEntryInfoX * inner_scope)
+{
+	tagEntryInfoX *scope = getNearestScopeInCorkQueue (inner_scope);
+
+	if (scope == NULL)
+		return "";
+	if (scope->fqName)
+		return scope->fqName;
+
+	ptrArray *pending = ptrArrayNew (NULL);
+	tagEntryInfoX *upper = scope;
+	do
+	{
+		ptrArrayAdd (pending, upper);
+		upper = getNearestScopeInCorkQueue ((tagEntryInfoX *)
+											getEntryInCorkQueue (upper->slot.extensionFields.scopeIndex));
+	}
+	while (upper && upper->fqName == NULL);
 
-	while ((c = stringListCount (queue)) > 0)
+	while (ptrArrayCount (pending) > 0)
 	{
-		v = stringListLast (queue);
-		vStringCat (n, v);
-		vStringDelete (v);
-		stringListRemoveLast (queue);
+		tagEntryInfoX *x = ptrArrayRemoveLast (pending);
+		x->fqName = makeFullQualifiedScopeName (x, upper);
+		upper = x;
 	}
-	stringListDelete (queue);
+	ptrArrayDelete (pending);
 
-	return vStringDeleteUnwrap (n);
+	return scope->fqName;
 }
 
 extern void getTagScopeInformation (tagEntryInfo *const tag,
@@ -817,8 +871,8 @@ extern void getTagScopeInformation (tagEntryInfo *const tag,
 	    && scope
 	    && ptrArrayCount (TagFile.corkQueue) > 0)
 	{
-		char *full_qualified_scope_name = getFullQualifiedScopeNameFromCorkQueue(scope);
-		Assert (full_qualified_scope_name);
+		char *full_qualified_scope_name
+			= eStrdup (getFullQualifiedScopeNameFromCorkQueue ((tagEntryInfoX *)scope));
 
 		/* Make the information reusable to generate full qualified entry, and xformat output*/
 		tag->extensionFields.scopeLangType = scope->langType;
@@ -868,6 +922,7 @@ static int   makePatternStringCommon (const tagEntryInfo *const tag,
 	    && (memcmp (&tag->filePosition, &cached_location, sizeof(MIOPos)) == 0))
 		return puts_func (vStringValue (cached_pattern), output);
 
+	profileEnterPhase (PROFILE_PATTERN);
 	line = readLineFromBypassForTag (TagFile.vLine, tag, NULL);
 	if (line == NULL)
 	{
@@ -918,6 +973,7 @@ static int   makePatternStringCommon (const tagEntryInfo *const tag,
 		TagFile.patternCacheValid = true;
 	}
 
+	profileLeavePhase ();
 	return length;
 }
 
@@ -1047,17 +1103,36 @@ static tagEntryInfo *newNilTagEntry (unsigned int corkFlags)
 {
 	tagEntryInfoX *x = xCalloc (1, tagEntryInfoX);
 	x->corkIndex = CORK_NIL;
-	x->symtab = RB_ROOT;
 	x->slot.kindIndex = KIND_FILE_INDEX;
 	return &(x->slot);
 }
 
+/* All tags in the cork queue come from a handful of input files;
+ * keep one copy of each file name instead of one per tag. */
+static const char *internCorkPath (const char *path)
+{
+	char *interned;
+
+	if (TagFile.lastCorkPath && strcmp (TagFile.lastCorkPath, path) == 0)
+		return TagFile.lastCorkPath;
+
+	interned = hashTableGetItem (TagFile.corkPaths, path);
+	if (interned == NULL)
+	{
+		interned = eStrdup (path);
+		hashTablePutItem (TagFile.corkPaths, interned, interned);
+	}
+	TagFile.lastCorkPath = interned;
+	return interned;
+}
+
 static tagEntryInfoX *copyTagEntry (const tagEntryInfo *const tag,
 								   unsigned int corkFlags)
 {
 	tagEntryInfoX *x = xMalloc (1, tagEntryInfoX);
-	x->symtab = RB_ROOT;
+	x->symtab = NULL;
 	x->corkIndex = CORK_NIL;
+	x->fqName = NULL;
 	tagEntryInfo  *slot = (tagEntryInfo *)x;
 
 	*slot = *tag;
@@ -1065,7 +1140,7 @@ static tagEntryInfoX *copyTagEntry (const tagEntryInfo *const tag,
 	if (slot->pattern)
 		slot->pattern = eStrdup (slot->pattern);
 
-	slot->inputFileName = eStrdup (slot->inputFileName);
+	slot->inputFileName = internCorkPath (slot->inputFileName);
 	slot->name = eStrdup (slot->name);
 	if (slot->extensionFields.access)
 		slot->extensionFields.access = eStrdup (slot->extensionFields.access);
@@ -1135,12 +1210,13 @@ static void deleteTagEnry (void *data)
 {
 	tagEntryInfo *slot = data;
 
+	hashTableDelete (((tagEntryInfoX *)slot)->symtab);
+
 	if (slot->kindIndex == KIND_FILE_INDEX)
 		goto out;
 
 	if (slot->pattern)
 		eFree ((char *)slot->pattern);
-	eFree ((char *)slot->inputFileName);
 	eFree ((char *)slot->name);
 
 	if (slot->extensionFields.access)
@@ -1170,59 +1246,71 @@ static void deleteTagEnry (void *data)
 
 	clearParserFields (slot);
 
+	if (((tagEntryInfoX *)slot)->fqName)
+		eFree (((tagEntryInfoX *)slot)->fqName);
+
  out:
 	eFree (slot);
 }
 
 static void corkSymtabPut (tagEntryInfoX *scope, const char* name, tagEntryInfoX *item)
 {
-	struct rb_root *root = &scope->symtab;
+	if (scope->symtab == NULL)
+		scope->symtab = hashTableNew (0, hashCstrhash, hashCstreq, NULL, NULL);
 
-	struct rb_node **new = &(root->rb_node), *parent = NULL;
+	verbose ("symtbl[:=] %s<-%s/%p (line: %lu)\n",
+			 scope->slot.name? scope->slot.name: "*root*",
+			 item->slot.name, &item->slot, item->slot.lineNumber);
+	hashTablePutItem (scope->symtab, (void *)name, item);
+}
 
-	while (*new)
-	{
-		tagEntryInfoX *this = container_of(*new, tagEntryInfoX, symnode);
-		int result = strcmp(item->slot.name, this->slot.name);
+struct corkSymtabChain {
+	tagEntryInfoX *first;
+	ptrArray *entries;
+	unsigned int count;
+};
 
-		parent = *new;
+static bool collectEntryInScope (const void *key CTAGS_ATTR_UNUSED, void *value, void *user_data)
+{
+	struct corkSymtabChain *chain = user_data;
 
-		if (result < 0)
-			new = &((*new)->rb_left);
-		else if (result > 0)
-			new = &((*new)->rb_right);
-		else
-		{
-			unsigned long lthis = this->slot.lineNumber;
-			unsigned long litem = item->slot.lineNumber;
-
-			/* Comparing lineNumber */
-			if (litem < lthis)
-				new = &((*new)->rb_left);
-			else if (litem > lthis)
-				new = &((*new)->rb_right);
-			else
-			{
-				/* Comparing memory address */
-				if (item < this)
-					new = &((*new)->rb_left);
-				else if (item > this)
-					new = &((*new)->rb_right);
-				else
-				{
-					AssertNotReached(); /* registering the same object twice. */
-					return;
-				}
-			}
-		}
-	}
+	if (chain->count++ == 0)
+		chain->first = value;
+	else if (chain->entries)
+		ptrArrayAdd (chain->entries, value);
+	return true;
+}
 
-	verbose ("symtbl[:=] %s<-%s/%p (line: %lu)\n",
-			*new? container_of(*new, tagEntryInfoX, symnode)->slot.name: "*root*",
-			 item->slot.name, &item->slot, item->slot.lineNumber);
-	/* Add new node and rebalance tree. */
-	rb_link_node(&item->symnode, parent, new);
-	rb_insert_color(&item->symnode, root);
+/* Entries having the same name are ordered by the line number, then
+ * by the address, as the red-black tree used here before did. */
+static int compareEntriesInScope (const void *a, const void *b)
+{
+	const tagEntryInfoX *ea = a;
+	const tagEntryInfoX *eb = b;
+
+	if (ea->slot.lineNumber < eb->slot.lineNumber)
+		return -1;
+	else if (ea->slot.lineNumber > eb->slot.lineNumber)
+		return 1;
+	else if (ea < eb)
+		return -1;
+	else if (ea > eb)
+		return 1;
+	return 0;
+}
+
+struct corkSymtabForeach {
+	entryForeachFunc func;
+	void *data;
+};
+
+static bool callForEntryInScope (const void *key CTAGS_ATTR_UNUSED, void *value, void *user_data)
+{
+	tagEntryInfoX *entry = value;
+	struct corkSymtabForeach *foreach = user_data;
+
+	verbose ("symtbl[< ] %s->%p\n", entry->slot.name, &entry->slot);
+	return foreach->func (entry->corkIndex, &entry->slot, foreach->data);
 }
 
 extern bool foreachEntriesInScope (int corkIndex,
@@ -1232,94 +1320,60 @@ extern bool foreachEntriesInScope (int corkIndex,
 {
 	tagEntryInfoX *x = ptrArrayItem (TagFile.corkQueue, corkIndex);
 
-	struct rb_root *root = &x->symtab;
-	tagEntryInfoX *rep = NULL;
-
-	/* More than one tag can have a same name.
-	 * Visit them from the last.
-	 *
-	 * 1. find one of them as the representative,
-	 * 2. find the last one of them from the representative with rb_next,
-	 * 3. call FUNC iteratively from the last to the first.
-	 */
-	if (name)
+	if (x->symtab == NULL)
 	{
-		struct rb_node *node = root->rb_node;
-		while (node)
-		{
-			tagEntryInfoX *entry = container_of(node, tagEntryInfoX, symnode);
-			int result;
-
-			result = strcmp(name, entry->slot.name);
-
-			if (result < 0)
-				node = node->rb_left;
-			else if (result > 0)
-				node = node->rb_right;
-			else
-			{
-				rep = entry;
-				break;
-			}
-		}
-		if (rep == NULL)
-			return true;
-
-		verbose("symtbl[<>] %s->%p\n", name, &rep->slot);
+		verbose ("symtbl[>V] %s->%p\n", name? name: "(null)", NULL);
+		return true;			/* Nothing here in this node. */
 	}
 
-	struct rb_node *last;
-
-	if (name)
-	{
-		struct rb_node *tmp = &rep->symnode;
-		last = tmp;
-
-		while ((tmp = rb_next (tmp)))
-		{
-			tagEntryInfoX *entry = container_of(tmp, tagEntryInfoX, symnode);
-			if (strcmp(name, entry->slot.name) == 0)
-			{
-				verbose ("symtbl[ >] %s->%p\n", name, &container_of(tmp, tagEntryInfoX, symnode)->slot);
-				last = tmp;
-			}
-			else
-				break;
-		}
-	}
-	else
+	/* No caller depends on the order of visiting all the entries
+	 * in a scope. */
+	if (name == NULL)
 	{
-		last = rb_last(root);
-		verbose ("last for %d<%p>: %p\n", corkIndex, root, last);
+		struct corkSymtabForeach foreach = {
+			.func = func,
+			.data = data,
+		};
+		return hashTableForeachItem (x->symtab, callForEntryInScope, &foreach);
 	}
 
-	if (!last)
-	{
-		verbose ("symtbl[>V] %s->%p\n", name? name: "(null)", NULL);
-		return true;			/* Nothing here in this node. */
-	}
+	/* More than one tag can have a same name.
+	 * Visit them from the last. */
+	struct corkSymtabChain chain = {
+		.first = NULL,
+		.entries = NULL,
+		.count = 0,
+	};
+	hashTableForeachItemOnChain (x->symtab, name, collectEntryInScope, &chain);
 
-	verbose ("symtbl[>|] %s->%p\n", name, &container_of(last, tagEntryInfoX, symnode)->slot);
+	if (chain.count == 0)
+		return true;
 
-	struct rb_node *cursor = last;
-	bool revisited_rep = false;
-	do
+	verbose ("symtbl[<>] %s->%p (%u)\n", name, &chain.first->slot, chain.count);
+	if (chain.count == 1)
+		return func (chain.first->corkIndex, &chain.first->slot, data);
+
+	chain.entries = ptrArrayNew (NULL);
+	chain.count = 0;
+	hashTableForeachItemOnChain (x->symtab, name, collectEntryInScope, &chain);
+	ptrArrayAdd (chain.entries, chain.first);
+	ptrArraySort (chain.entries, compareEntriesInScope);
+
+	bool r = true;
+	for (unsigned int i = ptrArrayCount (chain.entries); i > 0; i--)
 	{
-		tagEntryInfoX *entry = container_of(cursor, tagEntryInfoX, symnode);
-		if (!revisited_rep || !name || strcmp(name, entry->slot.name))
+		tagEntryInfoX *entry = ptrArrayItem (chain.entries, i - 1);
+
+		verbose ("symtbl[< ] %s->%p\n", name, &entry->slot);
+		if (!func (entry->corkIndex, &entry->slot, data))
 		{
-			verbose ("symtbl[< ] %s->%p\n", name, &entry->slot);
-			if (!func (entry->corkIndex, &entry->slot, data))
-				return false;
-			if (cursor == &rep->symnode)
-				revisited_rep = true;
-		}
-		else if (name)
+			r = false;
 			break;
+		}
 	}
-	while ((cursor = rb_prev(cursor)));
+	ptrArrayDelete (chain.entries);
 
-	return true;
+	return r;
 }
 
 static bool findName (int corkIndex, tagEntryInfo *entry, void *data)
@@ -1485,21 +1539,8 @@ static bool isTagWritable(const tagEntryInfo *const tag)
 			(makeRoleBit(available_roles)))
 			return false;
 
-		/* TODO: optimization
-		   A Bitmasks representing all enabled roles can be calculated at the
-		   end of initializing the parser. Calculating each time when checking
-		   a tag entry is not needed. */
-		for (unsigned int roleIndex = 0; roleIndex < available_roles; roleIndex++)
-		{
-			if (isRoleAssigned(tag, roleIndex))
-			{
-				if (isLanguageRoleEnabled (tag->langType, tag->kindIndex,
-											 roleIndex))
-					return true;
-			}
-
-		}
-		return false;
+		return (tag->extensionFields.roleBits
+				& getLanguageEnabledRoleBits (tag->langType, tag->kindIndex))? true: false;
 	}
 	else if (isLanguageKindRefOnly(tag->langType, tag->kindIndex))
 	{
@@ -1553,7 +1594,9 @@ static void writeTagEntry (const tagEntryInfo *const tag)
 		buildFqTagCache ( (tagEntryInfo *const)tag);
 	}
 
+	profileEnterPhase (PROFILE_WRITE);
 	length = writerWriteTag (TagFile.mio, tag);
+	profileLeavePhase ();
 
 	if (length > 0)
 	{
@@ -1592,6 +1635,8 @@ extern void corkTagFile(unsigned int corkFlags)
 	{
 		TagFile.corkFlags = corkFlags;
 		TagFile.corkQueue = ptrArrayNew (deleteTagEnry);
+		TagFile.corkPaths = hashTableNew (7, hashCstrhash, hashCstreq,
+										  eFree, NULL);
 		tagEntryInfo *nil = newNilTagEntry (corkFlags);
 		ptrArrayAdd (TagFile.corkQueue, nil);
 	}
@@ -1606,6 +1651,7 @@ extern void uncorkTagFile(void)
 	if (TagFile.cork > 0)
 		return ;
 
+	profileEnterPhase (PROFILE_UNCORK);
 	for (i = 1; i < ptrArrayCount (TagFile.corkQueue); i++)
 	{
 		tagEntryInfo *tag = ptrArrayItem (TagFile.corkQueue, i);
@@ -1630,6 +1676,10 @@ extern void uncorkTagFile(void)
 
 	ptrArrayDelete (TagFile.corkQueue);
 	TagFile.corkQueue = NULL;
+	hashTableDelete (TagFile.corkPaths);
+	TagFile.corkPaths = NULL;
+	TagFile.lastCorkPath = NULL;
+	profileLeavePhase ();
 }
 
 extern tagEntryInfo *getEntryInCorkQueue   (int n)
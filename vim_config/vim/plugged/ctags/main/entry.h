@@ -168,6 +168,10 @@ void          registerEntry (int corkIndex);
  * top-level entries. If name is NULL, this function traverses all entries
  * under the scope.
  *
+ * Entries for NAME are visited from the one appearing last in the input
+ * to the one appearing first. When NAME is NULL, the order is not
+ * specified.
+ *
  * If FUNC returns false, this function returns false.
  * If FUNC never returns false, this function returns true.
  * If FUNC is not called because no node for NAME in the symbol table,
@@ -30,6 +30,9 @@ extern void freeTagFileResources (void);
 extern const char *tagFileName (void);
 extern void openTagFile (void);
 extern void closeTagFile (const bool resize);
+/* When the tag file is unsorted and goes to stdout, also append what
+ * closeTagFile () writes there to CAPTURE.  NULL stops capturing. */
+extern void captureTagFileOutput (vString *capture);
 extern void  setupWriter (void *writerClientData);
 extern bool  teardownWriter (const char *inputFilename);
 
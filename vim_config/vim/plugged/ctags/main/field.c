@@ -1231,6 +1231,15 @@ extern bool isFieldEnabled (fieldType type)
 	return getFieldObject(type)->def->enabled;
 }
 
+extern bool isFieldRendered (fieldType type)
+{
+	if (!isFieldEnabled (type))
+		return false;
+
+	return writerDoesTreatFieldAsFixed (type)
+		|| writerCanPrintExtensionFields ();
+}
+
 extern bool enableField (fieldType type, bool state)
 {
 	fieldDefinition *def = getFieldObject(type)->def;
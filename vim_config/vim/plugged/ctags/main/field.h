@@ -121,4 +121,9 @@ struct sFieldDefinition {
 
 extern bool isFieldEnabled (fieldType type);
 
+/* Whether the current writer prints the field. A parser can skip
+ * building a costly value (signature, typeref, ...) if this returns
+ * false. The answer doesn't change while parsing an input file. */
+extern bool isFieldRendered (fieldType type);
+
 #endif	/* CTAGS_MAIN_FIELD_H */
@@ -22,23 +22,76 @@
 #include <errno.h>
 
 typedef union uFmtSpec {
-	char *const_str;
+	struct {
+		char *str;
+		size_t length;
+	} literal;
 	struct {
 		fieldType ftype;
 		int width;
-		char *raw_fmtstr;
+		bool leftJustified;
+		bool truncation;
 	} field;
 } fmtSpec;
 
+/* fmtNew compiles a format string to an array of these elements.
+ * The array is terminated by an element with NULL printer.
+ * fmtNew returns NULL instead of an empty array. */
 struct sFmtElement {
 	union uFmtSpec spec;
 	int (* printer) (fmtSpec*, MIO* fp, const tagEntryInfo *);
-	struct sFmtElement *next;
 };
 
 static int printLiteral (fmtSpec* fspec, MIO* fp, const tagEntryInfo * tag CTAGS_ATTR_UNUSED)
 {
-	return mio_puts (fp, fspec->const_str);
+	mio_write (fp, fspec->literal.str, 1, fspec->literal.length);
+	return fspec->literal.length;
+}
+
+static void printPadding (MIO* fp, size_t n)
+{
+	static const char spaces [] = "                                ";
+
+	while (n > 0)
+	{
+		size_t chunk = (n < sizeof (spaces) - 1)? n: sizeof (spaces) - 1;
+		mio_write (fp, spaces, 1, chunk);
+		n -= chunk;
+	}
+}
+
+/* Does what mio_printf with "%*s", "%-*s", "%.*s", or "%-.*s" did
+ * without parsing the format for every tag. */
+static int printFieldValue (fmtSpec* fspec, MIO* fp, const char *str)
+{
+	size_t width = fspec->field.width;
+	size_t len = strlen (str);
+
+	if (fspec->field.truncation)
+	{
+		if (width && len > width)
+			len = width;
+		mio_write (fp, str, 1, len);
+		return len;
+	}
+
+	if (len >= width)
+	{
+		mio_write (fp, str, 1, len);
+		return len;
+	}
+
+	if (fspec->field.leftJustified)
+	{
+		mio_write (fp, str, 1, len);
+		printPadding (fp, width - len);
+	}
+	else
+	{
+		printPadding (fp, width - len);
+		mio_write (fp, str, 1, len);
+	}
+	return width;
 }
 
 static bool isParserFieldCompatibleWithFtype (const tagField *pfield, int baseFtype)
@@ -51,76 +104,80 @@ static bool isParserFieldCompatibleWithFtype (const tagField *pfield, int baseFt
 	return false;
 }
 
-static int printTagField (fmtSpec* fspec, MIO* fp, const tagEntryInfo * tag)
+static int printCommonField (fmtSpec* fspec, MIO* fp, const tagEntryInfo * tag)
 {
-	int i;
-	int width = fspec->field.width;
-	int ftype;
-	const char* str = NULL;
+	const char* str = renderField (fspec->field.ftype, tag, NO_PARSER_FIELD);
 
-	ftype = fspec->field.ftype;
+	return printFieldValue (fspec, fp, str? str: "");
+}
 
-	if (isCommonField (ftype))
-		str = renderField (ftype, tag, NO_PARSER_FIELD);
-	else
-	{
-		unsigned int findex;
-		const tagField *f;
+static int printParserField (fmtSpec* fspec, MIO* fp, const tagEntryInfo * tag)
+{
+	int ftype = fspec->field.ftype;
+	const char* str = NULL;
+	unsigned int findex;
+	const tagField *f;
 
-		for (findex = 0; findex < tag->usedParserFields; findex++)
-		{
-			f = getParserFieldForIndex(tag, findex);
-			if (isParserFieldCompatibleWithFtype (f, ftype))
-				break;
-		}
+	for (findex = 0; findex < tag->usedParserFields; findex++)
+	{
+		f = getParserFieldForIndex(tag, findex);
+		if (isParserFieldCompatibleWithFtype (f, ftype))
+			break;
+	}
 
-		if (findex == tag->usedParserFields)
-			str = "";
-		else if (isFieldEnabled (f->ftype))
+	if (findex == tag->usedParserFields)
+		str = "";
+	else if (isFieldEnabled (f->ftype))
+	{
+		unsigned int dt = getFieldDataType (f->ftype);
+		if (dt & FIELDTYPE_STRING)
 		{
-			unsigned int dt = getFieldDataType (f->ftype);
-			if (dt & FIELDTYPE_STRING)
+			str = renderField (f->ftype, tag, findex);
+			if ((dt & FIELDTYPE_BOOL) && str[0] == '\0')
 			{
-				str = renderField (f->ftype, tag, findex);
-				if ((dt & FIELDTYPE_BOOL) && str[0] == '\0')
-				{
-					/* TODO: FIELD_NULL_LETTER_STRING */
-					str = "-";
-				}
-			}
-			else if (dt & FIELDTYPE_BOOL)
-				str = getFieldName (f->ftype);
-			else
-			{
-				/* Not implemented */
-				AssertNotReached ();
-				str = "CTAGS INTERNAL BUG!";
+				/* TODO: FIELD_NULL_LETTER_STRING */
+				str = "-";
 			}
 		}
+		else if (dt & FIELDTYPE_BOOL)
+			str = getFieldName (f->ftype);
+		else
+		{
+			/* Not implemented */
+			AssertNotReached ();
+			str = "CTAGS INTERNAL BUG!";
+		}
 	}
 
 	if (str == NULL)
 		str = "";
 
-	if (width)
-		i = mio_printf (fp, fspec->field.raw_fmtstr, width, str);
-	else
+	return printFieldValue (fspec, fp, str);
+}
+
+typedef struct sFmtCode {
+	fmtElement *elements;
+	unsigned int count;
+	unsigned int size;
+} fmtCode;
+
+static fmtElement *newElement (fmtCode *code)
+{
+	if (code->count == code->size)
 	{
-		mio_puts (fp, str);
-		i = strlen (str);
+		code->size = code->size? code->size * 2: 8;
+		code->elements = xRealloc (code->elements, code->size, fmtElement);
 	}
-	return i;
+	return code->elements + code->count++;
 }
 
-static fmtElement** queueLiteral (fmtElement **last, char *literal)
+static void queueLiteral (fmtCode *code, vString *literal)
 {
-	fmtElement *cur = xMalloc (1, fmtElement);
+	fmtElement *cur = newElement (code);
 
-	cur->spec.const_str = literal;
+	cur->spec.literal.length = vStringLength (literal);
+	cur->spec.literal.str = vStringDeleteUnwrap (literal);
 	cur->printer = printLiteral;
-	cur->next = NULL;
-	*last = cur;
-	return &(cur->next);
 }
 
 /* `getLanguageComponentInFieldName' is used as part of the option parameter
@@ -179,7 +236,7 @@ static langType getLanguageComponentInFieldName (const char *fullName,
 	return language;
 }
 
-static fmtElement** queueTagField (fmtElement **last, long width, bool truncation,
+static void queueTagField (fmtCode *code, long width, bool truncation,
 								   char field_letter, const char *field_name)
 {
 	fieldType ftype;
@@ -215,20 +272,12 @@ static fmtElement** queueTagField (fmtElement **last, long width, bool truncatio
 		error (FATAL, "The field cannot be printed in format output: %c", field_letter);
 	}
 
-	cur = xMalloc (1, fmtElement);
+	cur = newElement (code);
 
-	cur->spec.field.width = width;
 	cur->spec.field.ftype = ftype;
-
-	if (width < 0)
-	{
-		cur->spec.field.width *= -1;
-		cur->spec.field.raw_fmtstr = (truncation? "%-.*s": "%-*s");
-	}
-	else if (width > 0)
-		cur->spec.field.raw_fmtstr = (truncation? "%.*s": "%*s");
-	else
-		cur->spec.field.raw_fmtstr = NULL;
+	cur->spec.field.width = (width < 0)? -width: width;
+	cur->spec.field.leftJustified = (width < 0);
+	cur->spec.field.truncation = truncation;
 
 	enableField (ftype, true);
 	if (language == LANG_AUTO)
@@ -239,18 +288,14 @@ static fmtElement** queueTagField (fmtElement **last, long width, bool truncatio
 			enableField (ftype_next, true);
 	}
 
-	cur->printer = printTagField;
-	cur->next = NULL;
-	*last = cur;
-	return &(cur->next);
+	cur->printer = isCommonField (ftype)? printCommonField: printParserField;
 }
 
 extern fmtElement *fmtNew (const char*  fmtString)
 {
 	int i;
 	vString *literal = NULL;
-	fmtElement *code  = NULL;
-	fmtElement **last = &code;
+	fmtCode code = { NULL, 0, 0 };
 	bool found_percent = false;
 	long column_width;
 	const char*  cursor;
@@ -275,9 +320,8 @@ extern fmtElement *fmtNew (const char*  fmtString)
 				vString *width = NULL;
 				if (literal)
 				{
-					char* l = vStringDeleteUnwrap (literal);
+					queueLiteral (&code, literal);
 					literal = NULL;
-					last = queueLiteral (last, l);
 				}
 				if (cursor [i] == '-')
 				{
@@ -329,14 +373,14 @@ extern fmtElement *fmtNew (const char*  fmtString)
 					for (; cursor[i] != '}'; i++)
 						vStringPut (field_name, cursor[i]);
 
-					last = queueTagField (last, column_width, truncation,
-										  NUL_FIELD_LETTER, vStringValue (field_name));
+					queueTagField (&code, column_width, truncation,
+								   NUL_FIELD_LETTER, vStringValue (field_name));
 
 					vStringDelete (field_name);
 				}
 				else
-					last = queueTagField (last, column_width, truncation,
-										  cursor[i], NULL);
+					queueTagField (&code, column_width, truncation,
+								   cursor[i], NULL);
 			}
 
 		}
@@ -355,40 +399,42 @@ extern fmtElement *fmtNew (const char*  fmtString)
 	}
 	if (literal)
 	{
-		char* l = vStringDeleteUnwrap (literal);
+		queueLiteral (&code, literal);
 		literal = NULL;
-		last = queueLiteral (last, l);
 	}
-	return code;
+
+	/* Nothing is allocated for an empty format. Return NULL so that
+	 * the caller falls back to its default format. */
+	if (code.count == 0)
+		return NULL;
+	newElement (&code)->printer = NULL;
+	return code.elements;
 }
 
 extern int fmtPrint   (fmtElement * fmtelts, MIO* fp, const tagEntryInfo *tag)
 {
-	fmtElement *f = fmtelts;
+	fmtElement *f;
 	int i = 0;
-	while (f)
-	{
+
+	if (fmtelts == NULL)
+		return 0;
+
+	for (f = fmtelts; f->printer; f++)
 		i += f->printer (&(f->spec), fp, tag);
-		f = f->next;
-	}
 	return i;
 }
 
 extern void fmtDelete  (fmtElement * fmtelts)
 {
-	fmtElement *f = fmtelts;
-	fmtElement *next;
+	fmtElement *f;
 
-	while (f)
+	if (fmtelts == NULL)
+		return;
+
+	for (f = fmtelts; f->printer; f++)
 	{
-		next = f->next;
 		if (f->printer == printLiteral)
-		{
-			eFree (f->spec.const_str);
-			f->spec.const_str = NULL;
-		}
-		f->next = NULL;
-		eFree (f);
-		f = next;
+			eFree (f->spec.literal.str);
 	}
+	eFree (fmtelts);
 }
@@ -23,6 +23,9 @@
 #ifndef xMalloc
 #define xMalloc(n,Type)    (Type *)malloc((size_t)(n) * sizeof (Type))
 #endif
+#ifndef xRealloc
+#define xRealloc(p,n,Type) (Type *)realloc((p), (n) * sizeof (Type))
+#endif
 #ifndef eFree
 #define eFree(x) free(x)
 #endif
@@ -31,16 +34,45 @@
 #include <string.h>
 
 
+/* Items are stored in an array in the order of insertion. The slots
+ * of the table refer the items with open addressing (linear probing).
+ *
+ * A slot holds SLOT_EMPTY, SLOT_DELETED, or the index of an item
+ * plus SLOT_ITEM_BASE.
+ *
+ * Slots for items having the same key are ordered from the newest to
+ * the oldest along the probe sequence. So the first match is the
+ * "first occurrence" item for the key.
+ *
+ * Deleting an item leaves a hole in the item array, and a SLOT_DELETED
+ * in the table. Both are reclaimed when the table is rebuilt. The holes
+ * are kept while iterating over the items. */
+#define SLOT_EMPTY      0
+#define SLOT_DELETED    1
+#define SLOT_ITEM_BASE  2
+
+#define MIN_TABLE_SIZE  8
+
 typedef struct sHashEntry hentry;
 struct sHashEntry {
 	void *key;
 	void *value;
-	hentry *next;
+	unsigned int hash;
+	bool used;
 };
 
 struct sHashTable {
-	hentry** table;
-	unsigned int size;
+	unsigned int *table;
+	unsigned int size;		/* the number of slots; power of 2 or 0 */
+	unsigned int filled;	/* slots not SLOT_EMPTY */
+
+	hentry *items;
+	unsigned int nitems;	/* including holes */
+	unsigned int nused;
+	unsigned int itemsSize;
+
+	unsigned int initialSize;
+	unsigned int iterating;	/* hashTableForeachItem () is running */
 	hashTableHashFunc hashfn;
 	hashTableEqualFunc equalfn;
 	hashTableDeleteFunc keyfreefn;
@@ -49,22 +81,16 @@ struct sHashTable {
 	hashTableDeleteFunc valForNotUnknownKeyfreefn;
 };
 
-struct chainTracker {
-	const void *const target_key;
-	hashTableForeachFunc user_proc;
-	void *user_data;
-	hashTableEqualFunc equalfn;
-};
-
-static hentry* entry_new (void *key, void *value, hentry* next)
+/* Hash functions like hashPtrhash () give values whose lower bits are
+ * biased. Mix them before masking. */
+static unsigned int mix (unsigned int h)
 {
-	hentry* entry = xMalloc (1, hentry);
-
-	entry->key = key;
-	entry->value = value;
-	entry->next = next;
-
-	return entry;
+	h ^= h >> 16;
+	h *= 0x85ebca6bU;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35U;
+	h ^= h >> 16;
+	return h;
 }
 
 static void entry_reset  (hentry* entry,
@@ -81,78 +107,146 @@ static void entry_reset  (hentry* entry,
 	entry->value = newval;
 }
 
-static hentry* entry_destroy (hentry* entry,
-			      hashTableDeleteFunc keyfreefn,
-			      hashTableDeleteFunc valfreefn)
+static unsigned int table_size_for (unsigned int nitems)
 {
-	hentry* tmp;
+	unsigned int size = MIN_TABLE_SIZE;
 
-	entry_reset (entry, NULL, NULL, keyfreefn, valfreefn);
-	tmp = entry->next;
-	eFree (entry);
-
-	return tmp;
+	/* Keep the load factor under 1/2 after rebuilding. */
+	while (size < nitems * 2)
+		size *= 2;
+	return size;
 }
 
-static void  entry_reclaim (hentry* entry,
-			    hashTableDeleteFunc keyfreefn,
-			    hashTableDeleteFunc valfreefn)
+static void table_rebuild (hashTable *htable, unsigned int size)
 {
-	while (entry)
-		entry = entry_destroy (entry, keyfreefn, valfreefn);
-}
+	unsigned int i, j;
+	unsigned int mask = size - 1;
 
-static void *entry_find (hentry* entry, const void* const key, hashTableEqualFunc equalfn,
-						 void *valForNotUnknownKey)
-{
-	while (entry)
+	/* Remove the holes in the item array. */
+	if (!htable->iterating)
+	{
+		for (i = 0, j = 0; i < htable->nitems; i++)
+		{
+			if (htable->items[i].used)
+			{
+				if (i != j)
+					htable->items[j] = htable->items[i];
+				j++;
+			}
+		}
+		htable->nitems = j;
+	}
+
+	if (size != htable->size)
 	{
-		if (equalfn( key, entry->key))
-			return entry->value;
-		entry = entry->next;
+		if (htable->table)
+			eFree (htable->table);
+		htable->table = xMalloc (size, unsigned int);
+		htable->size = size;
 	}
-	return valForNotUnknownKey;
+	memset (htable->table, 0, sizeof (*htable->table) * size);
+
+	/* Inserting from the newest item keeps the order of the items
+	 * having the same key without comparing keys. */
+	for (i = htable->nitems; i > 0; i--)
+	{
+		if (!htable->items[i - 1].used)
+			continue;
+
+		unsigned int s = mix (htable->items[i - 1].hash) & mask;
+		while (htable->table[s] != SLOT_EMPTY)
+			s = (s + 1) & mask;
+		htable->table[s] = (i - 1) + SLOT_ITEM_BASE;
+	}
+	htable->filled = htable->nused;
 }
 
-static bool		entry_delete (hentry **entry, const void *key, hashTableEqualFunc equalfn,
-			      hashTableDeleteFunc keyfreefn, hashTableDeleteFunc valfreefn)
+static unsigned int item_new (hashTable *htable, void *key, void *value, unsigned int hash)
 {
-	while (*entry)
+	if (htable->nitems == htable->itemsSize)
 	{
-		if (equalfn (key, (*entry)->key))
-		{
-			*entry = entry_destroy (*entry, keyfreefn, valfreefn);
-			return true;
-		}
-		entry = &((*entry)->next);
+		htable->itemsSize = htable->itemsSize? htable->itemsSize * 2: htable->size / 2;
+		htable->items = xRealloc (htable->items, htable->itemsSize, hentry);
 	}
-	return false;
+
+	hentry *entry = htable->items + htable->nitems;
+	entry->key = key;
+	entry->value = value;
+	entry->hash = hash;
+	entry->used = true;
+	htable->nused++;
+	return htable->nitems++;
+}
+
+static void table_reserve (hashTable *htable)
+{
+	/* Keep the slots including SLOT_DELETED under 3/4 of the table. */
+	if (htable->size == 0)
+		table_rebuild (htable, table_size_for (htable->initialSize));
+	else if ((htable->filled + 1) * 4 > htable->size * 3)
+		table_rebuild (htable, table_size_for (htable->nused + 1));
 }
 
-static bool		entry_update (hentry *entry, void *key, void *value, hashTableEqualFunc equalfn,
-			      hashTableDeleteFunc keyfreefn, hashTableDeleteFunc valfreefn)
+/* Return the slot for the first occurrence item for KEY, or NULL.
+ * If FROM is given, look for the next occurrence after the slot *FROM,
+ * and store the slot found to *FROM. */
+static unsigned int *table_find (hashTable *htable, const void *key, unsigned int hash,
+								 unsigned int *from)
 {
-	while (entry)
+	unsigned int mask;
+	unsigned int s;
+
+	if (htable->size == 0)
+		return NULL;
+
+	mask = htable->size - 1;
+	s = from? ((*from + 1) & mask): (mix (hash) & mask);
+
+	while (htable->table[s] != SLOT_EMPTY)
 	{
-		if (equalfn (key, entry->key))
+		if (htable->table[s] != SLOT_DELETED)
 		{
-			entry_reset (entry, key, value, keyfreefn, valfreefn);
-			return true;
+			hentry *entry = htable->items + (htable->table[s] - SLOT_ITEM_BASE);
+			if (entry->hash == hash && htable->equalfn (key, entry->key))
+			{
+				if (from)
+					*from = s;
+				return htable->table + s;
+			}
 		}
-		entry = entry->next;
+		s = (s + 1) & mask;
 	}
-	return false;
+	return NULL;
 }
 
-static bool  entry_foreach (hentry *entry, hashTableForeachFunc proc, void *user_data)
+static void table_insert (hashTable *htable, void *key, void *value, unsigned int hash)
 {
-	while (entry)
+	unsigned int mask;
+	unsigned int s;
+	unsigned int carried;
+
+	table_reserve (htable);
+	mask = htable->size - 1;
+	s = mix (hash) & mask;
+	carried = item_new (htable, key, value, hash) + SLOT_ITEM_BASE;
+
+	/* Shift the older items having the same key toward the end of the
+	 * probe sequence. */
+	while (htable->table[s] > SLOT_DELETED)
 	{
-		if (!proc (entry->key, entry->value, user_data))
-			return false;
-		entry = entry->next;
+		hentry *entry = htable->items + (htable->table[s] - SLOT_ITEM_BASE);
+		if (entry->hash == hash && htable->equalfn (key, entry->key))
+		{
+			unsigned int tmp = htable->table[s];
+			htable->table[s] = carried;
+			carried = tmp;
+		}
+		s = (s + 1) & mask;
 	}
-	return true;
+
+	if (htable->table[s] == SLOT_EMPTY)
+		htable->filled++;
+	htable->table[s] = carried;
 }
 
 extern hashTable *hashTableNew    (unsigned int size,
@@ -163,9 +257,11 @@ extern hashTable *hashTableNew    (unsigned int size,
 {
 	hashTable *htable;
 
-	htable = xMalloc (1, hashTable);
-	htable->size = size;
-	htable->table = xCalloc (size, hentry*);
+	htable = xCalloc (1, hashTable);
+
+	/* The table grows as needed. SIZE is just a hint. The slots are
+	 * allocated when the first item is put. */
+	htable->initialSize = size;
 
 	htable->hashfn = hashfn;
 	htable->equalfn = equalfn;
@@ -197,7 +293,10 @@ extern void       hashTableDelete (hashTable *htable)
 
 	if (htable->valForNotUnknownKeyfreefn)
 		htable->valForNotUnknownKeyfreefn (htable->valForNotUnknownKey);
-	eFree (htable->table);
+	if (htable->table)
+		eFree (htable->table);
+	if (htable->items)
+		eFree (htable->items);
 	eFree (htable);
 }
 
@@ -207,51 +306,71 @@ extern void       hashTableClear (hashTable *htable)
 	if (!htable)
 		return;
 
-	for (i = 0; i < htable->size; i++)
+	for (i = 0; i < htable->nitems; i++)
 	{
-		hentry *entry;
-
-		entry = htable->table[i];
-		entry_reclaim (entry, htable->keyfreefn, htable->valfreefn);
-		htable->table[i] = NULL;
+		if (htable->items[i].used)
+			entry_reset (htable->items + i, NULL, NULL,
+						 htable->keyfreefn, htable->valfreefn);
 	}
+	htable->nitems = 0;
+	htable->nused = 0;
+	htable->filled = 0;
+	if (htable->table)
+		memset (htable->table, 0, sizeof (*htable->table) * htable->size);
 }
 
 extern void       hashTablePutItem    (hashTable *htable, void *key, void *value)
 {
-	unsigned int i;
-
-	i = htable->hashfn (key) % htable->size;
-	htable->table[i] = entry_new(key, value, htable->table[i]);
+	table_insert (htable, key, value, htable->hashfn (key));
 }
 
 extern void*      hashTableGetItem   (hashTable *htable, const void * key)
 {
-	unsigned int i;
+	unsigned int *slot;
+
+	if (htable->nused == 0)
+		return htable->valForNotUnknownKey;
 
-	i = htable->hashfn (key) % htable->size;
-	return entry_find(htable->table[i], key, htable->equalfn, htable->valForNotUnknownKey);
+	slot = table_find (htable, key, htable->hashfn (key), NULL);
+	if (slot)
+		return htable->items[*slot - SLOT_ITEM_BASE].value;
+	return htable->valForNotUnknownKey;
 }
 
 extern bool     hashTableDeleteItem (hashTable *htable, const void *key)
 {
-	unsigned int i;
+	unsigned int *slot;
+	hentry *entry;
+
+	if (htable->nused == 0)
+		return false;
+
+	slot = table_find (htable, key, htable->hashfn (key), NULL);
+	if (!slot)
+		return false;
 
-	i = htable->hashfn (key) % htable->size;
-	return entry_delete(&htable->table[i], key,
-			    htable->equalfn, htable->keyfreefn, htable->valfreefn);
+	entry = htable->items + (*slot - SLOT_ITEM_BASE);
+	entry_reset (entry, NULL, NULL, htable->keyfreefn, htable->valfreefn);
+	entry->used = false;
+	htable->nused--;
+	*slot = SLOT_DELETED;
+	return true;
 }
 
 extern bool    hashTableUpdateItem (hashTable *htable, void *key, void *value)
 {
-	unsigned int i;
+	unsigned int hash = htable->hashfn (key);
+	unsigned int *slot = table_find (htable, key, hash, NULL);
 
-	i = htable->hashfn (key) % htable->size;
-	bool r = entry_update(htable->table[i], key, value,
-						  htable->equalfn, htable->keyfreefn, htable->valfreefn);
-	if (!r)
-		htable->table[i] = entry_new(key, value, htable->table[i]);
-	return r;
+	if (slot)
+	{
+		entry_reset (htable->items + (*slot - SLOT_ITEM_BASE), key, value,
+					 htable->keyfreefn, htable->valfreefn);
+		return true;
+	}
+
+	table_insert (htable, key, value, hash);
+	return false;
 }
 
 extern bool    hashTableHasItem    (hashTable *htable, const void *key)
@@ -262,53 +381,50 @@ extern bool    hashTableHasItem    (hashTable *htable, const void *key)
 extern bool       hashTableForeachItem (hashTable *htable, hashTableForeachFunc proc, void *user_data)
 {
 	unsigned int i;
+	bool r = true;
 
-	for (i = 0; i < htable->size; i++)
-		if (!entry_foreach(htable->table[i], proc, user_data))
-			return false;
-	return true;
-}
-
-static bool track_chain (const void *const key, void *value, void *chain_data)
-{
-	struct chainTracker *chain_tracker = chain_data;
-
-	if (chain_tracker->equalfn (chain_tracker->target_key, key))
+	/* Visit the newest item first as the old chained implementation
+	 * did for items in a chain. PROC may put items to HTABLE; they are
+	 * not visited. */
+	htable->iterating++;
+	for (i = htable->nitems; i > 0; i--)
 	{
-		if (! chain_tracker->user_proc (key, value, chain_tracker->user_data))
-			return false;
+		hentry *entry = htable->items + i - 1;
+		if (entry->used && !proc (entry->key, entry->value, user_data))
+		{
+			r = false;
+			break;
+		}
 	}
-	return true;
+	htable->iterating--;
+	return r;
 }
 
 extern bool       hashTableForeachItemOnChain (hashTable *htable, const void *key, hashTableForeachFunc proc, void *user_data)
 {
-	unsigned int i;
-	struct chainTracker chain_tracker = {
-		.target_key = key,
-		.user_proc = proc,
-		.user_data = user_data,
-		.equalfn   = htable->equalfn,
-	};
-
-	i = htable->hashfn (key) % htable->size;
-	if (!entry_foreach(htable->table[i], track_chain, &chain_tracker))
-		return false;
-	return true;
-}
+	unsigned int hash = htable->hashfn (key);
+	unsigned int s = 0;
+	unsigned int *slot;
 
-static bool count (const void *const key CTAGS_ATTR_UNUSED, void *value CTAGS_ATTR_UNUSED, void *data)
-{
-	int *c = data;
-	++*c;
+	if (htable->nused == 0)
+		return true;
+
+	slot = table_find (htable, key, hash, NULL);
+	if (slot)
+		s = (unsigned int)(slot - htable->table);
+	while (slot)
+	{
+		hentry *entry = htable->items + (*slot - SLOT_ITEM_BASE);
+		if (! proc (entry->key, entry->value, user_data))
+			return false;
+		slot = table_find (htable, key, hash, &s);
+	}
 	return true;
 }
 
 extern unsigned int hashTableCountItem   (hashTable *htable)
 {
-	int c = 0;
-	hashTableForeachItem (htable, count, &c);
-	return c;
+	return htable->nused;
 }
 
 unsigned int hashPtrhash (const void * const x)
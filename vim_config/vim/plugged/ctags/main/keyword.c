@@ -12,8 +12,8 @@
 */
 #include "general.h"  /* must always come first */
 
+#include <limits.h>
 #include <string.h>
-#include <ctype.h>
 
 #include "debug.h"
 #include "keyword.h"
@@ -27,79 +27,138 @@
 typedef struct sHashEntry {
 	struct sHashEntry *next;
 	const char *string;
-	langType language;
+	unsigned int hash;
+	unsigned int length;
 	int value;
 } hashEntry;
 
+/* Keywords of a language. Most tokens passed to lookupKeyword () are
+ * not keywords. firstChars and the range of lengths reject most of
+ * them before hashing and walking a chain. */
+typedef struct sKeywordSet {
+	hashEntry **buckets;
+	unsigned int size;			/* power of 2 */
+	unsigned int count;
+	unsigned int minLength;
+	unsigned int maxLength;
+	unsigned char firstChars [256 / 8];	/* first characters in lower case */
+} keywordSet;
+
 /*
 *   DATA DEFINITIONS
 */
-static const unsigned int TableSize = 2039;  /* prime */
-static hashEntry **HashTable = NULL;
+static const unsigned int InitialTableSize = 64;
+static keywordSet *KeywordTables = NULL;
+static unsigned int KeywordTableCount = 0;
 
 /*
 *   FUNCTION DEFINITIONS
 */
 
-static hashEntry **getHashTable (void)
+static keywordSet *getKeywordTable (langType language, bool creating)
 {
-	static bool allocated = false;
+	if (language < 0)
+		return NULL;
 
-	if (! allocated)
+	if ((unsigned int)language >= KeywordTableCount)
 	{
-		unsigned int i;
-
-		HashTable = xMalloc (TableSize, hashEntry*);
+		if (!creating)
+			return NULL;
+
+		unsigned int count = language + 1;
+		KeywordTables = xRealloc (KeywordTables, count, keywordSet);
+		memset (KeywordTables + KeywordTableCount, 0,
+				sizeof (keywordSet) * (count - KeywordTableCount));
+		KeywordTableCount = count;
+	}
 
-		for (i = 0  ;  i < TableSize  ;  ++i)
-			HashTable [i] = NULL;
+	keywordSet *table = KeywordTables + language;
+	if (table->buckets == NULL)
+	{
+		if (!creating)
+			return NULL;
 
-		allocated = true;
+		table->size = InitialTableSize;
+		table->buckets = xCalloc (table->size, hashEntry*);
 	}
-	return HashTable;
+	return table;
 }
 
-static hashEntry *getHashTableEntry (unsigned long hashedValue)
+static int lowerChar (int c)
 {
-	hashEntry **const table = getHashTable ();
-	hashEntry *entry;
-
-	Assert (hashedValue < TableSize);
-	entry = table [hashedValue];
+	/* Keywords are in ASCII. tolower () is slow on the hot path. */
+	return ('A' <= c && c <= 'Z')? c - 'A' + 'a': c;
+}
 
-	return entry;
+static bool hasFirstChar (const keywordSet *const table, unsigned char c)
+{
+	c = (unsigned char) lowerChar (c);
+	return (table->firstChars [c / 8] >> (c % 8)) & 1;
 }
 
-static unsigned int hashValue (const char *const string, langType language)
+/* Returns false if STRING is longer than MAXLENGTH. */
+static bool hashValue (const char *const string, unsigned int maxLength,
+					   unsigned int *hash, unsigned int *length)
 {
-	const signed char *p;
+	const unsigned char *p;
 	unsigned int h = 5381;
 
 	Assert (string != NULL);
 
 	/* "djb" hash as used in g_str_hash() in glib */
-	for (p = (const signed char *)string; *p != '\0'; p++)
-		h = (h << 5) + h + tolower (*p);
-
-	/* consider language as an extra "character" and add it to the hash */
-	h = (h << 5) + h + language;
+	for (p = (const unsigned char *)string; *p != '\0'; p++)
+	{
+		if ((unsigned int)(p - (const unsigned char *)string) >= maxLength)
+			return false;
+		h = (h << 5) + h + lowerChar (*p);
+	}
 
-	return h;
+	*hash = h;
+	*length = (unsigned int)(p - (const unsigned char *)string);
+	return true;
 }
 
 static hashEntry *newEntry (
-		const char *const string, langType language, int value)
+		const char *const string, unsigned int hash, unsigned int length, int value)
 {
 	hashEntry *const entry = xMalloc (1, hashEntry);
 
 	entry->next     = NULL;
 	entry->string   = string;
-	entry->language = language;
+	entry->hash     = hash;
+	entry->length   = length;
 	entry->value    = value;
 
 	return entry;
 }
 
+static void growKeywordTable (keywordSet *const table)
+{
+	unsigned int size = table->size * 2;
+	hashEntry **buckets = xCalloc (size, hashEntry*);
+
+	for (unsigned int i = 0; i < table->size; i++)
+	{
+		hashEntry *entry = table->buckets [i];
+		while (entry != NULL)
+		{
+			hashEntry *next = entry->next;
+			hashEntry **last = buckets + (entry->hash & (size - 1));
+
+			/* Keep the order in the chain. */
+			while (*last)
+				last = &(*last)->next;
+			entry->next = NULL;
+			*last = entry;
+			entry = next;
+		}
+	}
+
+	eFree (table->buckets);
+	table->buckets = buckets;
+	table->size = size;
+}
+
 /*  Note that it is assumed that a "value" of zero means an undefined keyword
  *  and clients of this function should observe this. Also, all keywords added
  *  should be added in lower case. If we encounter a case-sensitive language
@@ -107,54 +166,57 @@ static hashEntry *newEntry (
  */
 extern void addKeyword (const char *const string, langType language, int value)
 {
-	const unsigned int index = hashValue (string, language) % TableSize;
-	hashEntry *entry = getHashTableEntry (index);
+	keywordSet *const table = getKeywordTable (language, true);
+	unsigned int hash = 0, length = 0;
+	unsigned char first;
 
-	if (entry == NULL)
-	{
-		hashEntry **const table = getHashTable ();
-		table [index] = newEntry (string, language, value);
-	}
-	else
-	{
-		hashEntry *prev = NULL;
+	hashValue (string, UINT_MAX, &hash, &length);
 
-		while (entry != NULL)
-		{
-			if (language == entry->language  &&
-				strcmp (string, entry->string) == 0)
-			{
-				Assert (("Already in table" == NULL));
-			}
-			prev = entry;
-			entry = entry->next;
-		}
-		if (entry == NULL)
+	if (table->count >= table->size)
+		growKeywordTable (table);
+
+	hashEntry **last = table->buckets + (hash & (table->size - 1));
+	while (*last != NULL)
+	{
+		if (strcmp (string, (*last)->string) == 0)
 		{
-			Assert (prev != NULL);
-			prev->next = newEntry (string, language, value);
+			Assert (("Already in table" == NULL));
 		}
+		last = &(*last)->next;
 	}
+	*last = newEntry (string, hash, length, value);
+	table->count++;
+
+	if (table->count == 1 || length < table->minLength)
+		table->minLength = length;
+	if (length > table->maxLength)
+		table->maxLength = length;
+	first = (unsigned char) lowerChar ((unsigned char) string [0]);
+	table->firstChars [first / 8] |= 1 << (first % 8);
 }
 
 static int lookupKeywordFull (const char *const string, bool caseSensitive, langType language)
 {
-	const unsigned int index = hashValue (string, language) % TableSize;
-	hashEntry *entry = getHashTableEntry (index);
-	int result = KEYWORD_NONE;
+	const keywordSet *const table = getKeywordTable (language, false);
+	unsigned int hash, length;
+	hashEntry *entry;
+
+	if (table == NULL
+		|| !hasFirstChar (table, (unsigned char) string [0])
+		|| !hashValue (string, table->maxLength, &hash, &length)
+		|| length < table->minLength)
+		return KEYWORD_NONE;
 
-	while (entry != NULL)
+	for (entry = table->buckets [hash & (table->size - 1)];
+		 entry != NULL;
+		 entry = entry->next)
 	{
-		if (language == entry->language &&
-			((caseSensitive && strcmp (string, entry->string) == 0) ||
-			 (!caseSensitive && strcasecmp (string, entry->string) == 0)))
-		{
-			result = entry->value;
-			break;
-		}
-		entry = entry->next;
+		if (entry->hash == hash && entry->length == length &&
+			((caseSensitive && memcmp (string, entry->string, length) == 0) ||
+			 (!caseSensitive && strncasecmp (string, entry->string, length) == 0)))
+			return entry->value;
 	}
-	return result;
+	return KEYWORD_NONE;
 }
 
 extern int lookupKeyword (const char *const string, langType language)
@@ -169,13 +231,16 @@ extern int lookupCaseKeyword (const char *const string, langType language)
 
 extern void freeKeywordTable (void)
 {
-	if (HashTable != NULL)
+	for (unsigned int l = 0; l < KeywordTableCount; l++)
 	{
-		unsigned int i;
+		keywordSet *const table = KeywordTables + l;
+
+		if (table->buckets == NULL)
+			continue;
 
-		for (i = 0  ;  i < TableSize  ;  ++i)
+		for (unsigned int i = 0  ;  i < table->size  ;  ++i)
 		{
-			hashEntry *entry = HashTable [i];
+			hashEntry *entry = table->buckets [i];
 
 			while (entry != NULL)
 			{
@@ -184,21 +249,26 @@ extern void freeKeywordTable (void)
 				entry = next;
 			}
 		}
-		eFree (HashTable);
+		eFree (table->buckets);
 	}
+
+	if (KeywordTables)
+		eFree (KeywordTables);
+	KeywordTables = NULL;
+	KeywordTableCount = 0;
 }
 
 #ifdef DEBUG
 
-static void printEntry (const hashEntry *const entry)
+static void printEntry (const hashEntry *const entry, langType language)
 {
-	printf ("  %-15s %-7s\n", entry->string, getLanguageName (entry->language));
+	printf ("  %-15s %-7s\n", entry->string, getLanguageName (language));
 }
 
-static unsigned int printBucket (const unsigned int i)
+static unsigned int printBucket (const keywordSet *const table, langType language,
+								 const unsigned int i)
 {
-	hashEntry **const table = getHashTable ();
-	hashEntry *entry = table [i];
+	hashEntry *entry = table->buckets [i];
 	unsigned int measure = 1;
 	bool first = true;
 
@@ -214,7 +284,7 @@ static unsigned int printBucket (const unsigned int i)
 			printf (" ");
 			first = false;
 		}
-		printEntry (entry);
+		printEntry (entry, language);
 		entry = entry->next;
 		measure = 2 * measure;
 	}
@@ -225,15 +295,19 @@ extern void printKeywordTable (void)
 {
 	unsigned long emptyBucketCount = 0;
 	unsigned long measure = 0;
-	unsigned int i;
 
-	for (i = 0  ;  i < TableSize  ;  ++i)
+	for (unsigned int l = 0; l < KeywordTableCount; l++)
 	{
-		const unsigned int pass = printBucket (i);
+		const keywordSet *const table = KeywordTables + l;
+
+		for (unsigned int i = 0  ;  i < table->size  ;  ++i)
+		{
+			const unsigned int pass = printBucket (table, l, i);
 
-		measure += pass;
-		if (pass == 0)
-			++emptyBucketCount;
+			measure += pass;
+			if (pass == 0)
+				++emptyBucketCount;
+		}
 	}
 
 	printf ("spread measure = %ld\n", measure);
@@ -244,15 +318,18 @@ extern void printKeywordTable (void)
 
 extern void dumpKeywordTable (FILE *fp)
 {
-	unsigned int i;
-	for (i = 0  ;  i < TableSize  ;  ++i)
+	for (unsigned int l = 0; l < KeywordTableCount; l++)
 	{
-		hashEntry **const table = getHashTable ();
-		hashEntry *entry = table [i];
-		while (entry != NULL)
+		const keywordSet *const table = KeywordTables + l;
+
+		for (unsigned int i = 0  ;  i < table->size  ;  ++i)
 		{
-			fprintf(fp, "%s	%s\n", entry->string, getLanguageName (entry->language));
-			entry = entry->next;
+			hashEntry *entry = table->buckets [i];
+			while (entry != NULL)
+			{
+				fprintf(fp, "%s	%s\n", entry->string, getLanguageName (l));
+				entry = entry->next;
+			}
 		}
 	}
 }
@@ -19,7 +19,7 @@
 #include "colprint_p.h"
 #include "ctags.h"
 #include "debug.h"
-#include "entry.h"
+#include "entry_p.h"
 #include "kind.h"
 #include "parse_p.h"
 #include "options.h"
@@ -36,8 +36,16 @@ struct roleControlBlock {
 	roleObject *role;
 	unsigned int count;
 	int owner;
+
+	/* Cache for getEnabledRoleBits (); valid while enabledBitsStamp
+	 * equals roleStateStamp. */
+	roleBitsType enabledBits;
+	unsigned int enabledBitsStamp;
 };
 
+/* Incremented whenever a role is enabled, disabled or defined. */
+static unsigned int roleStateStamp = 1;
+
 typedef struct sKindObject {
 	kindDefinition *def;
 	freeKindDefFunc free;
@@ -84,6 +92,7 @@ extern void enableKind (kindDefinition *kind, bool enable)
 extern void enableRole (roleDefinition *role, bool enable)
 {
 	role->enabled = enable;
+	roleStateStamp++;
 }
 
 static void initRoleObject (roleObject *robj, roleDefinition *rdef, freeRoleDefFunc freefunc, int roleId)
@@ -106,6 +115,8 @@ static struct roleControlBlock* allocRoleControlBlock (kindObject *kind)
 	rcb = xMalloc(1, struct roleControlBlock);
 	rcb->count = kind->def->nRoles;
 	rcb->owner = kind->def->id;
+	rcb->enabledBits = 0;
+	rcb->enabledBitsStamp = 0;
 	rcb->role = xMalloc(rcb->count, roleObject);
 	for (j = 0; j < rcb->count; j++)
 		initRoleObject (rcb->role + j, kind->def->roles + j, NULL, j);
@@ -215,6 +226,7 @@ extern int defineRole (struct kindControlBlock* kcb, int kindIndex,
 
 	rcb->role = xRealloc (rcb->role, rcb->count, roleObject);
 	initRoleObject (rcb->role + roleIndex, def, freeRoleDef, roleIndex);
+	roleStateStamp++;
 
 	return roleIndex;
 }
@@ -225,6 +237,23 @@ extern bool isRoleEnabled (struct kindControlBlock* kcb, int kindIndex, int role
 	return rdef->enabled;
 }
 
+extern roleBitsType getEnabledRoleBits (struct kindControlBlock* kcb, int kindIndex)
+{
+	struct roleControlBlock *rcb = kcb->kind[kindIndex].rcb;
+
+	if (rcb->enabledBitsStamp != roleStateStamp)
+	{
+		rcb->enabledBits = 0;
+		for (unsigned int i = 0; i < rcb->count; i++)
+		{
+			if (rcb->role[i].def->enabled)
+				rcb->enabledBits |= makeRoleBit (i);
+		}
+		rcb->enabledBitsStamp = roleStateStamp;
+	}
+	return rcb->enabledBits;
+}
+
 extern unsigned int countKinds (struct kindControlBlock* kcb)
 {
 	return kcb->count;
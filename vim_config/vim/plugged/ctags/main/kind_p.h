@@ -13,6 +13,7 @@
 */
 
 #include "general.h"
+#include "entry.h"
 #include "vstring.h"
 
 
@@ -40,6 +41,7 @@ extern int  defineKind (struct kindControlBlock* kcb, kindDefinition *def,
 extern int defineRole (struct kindControlBlock* kcb, int kindIndex,
 					   roleDefinition *def, freeRoleDefFunc freeRoleDef);
 extern bool isRoleEnabled (struct kindControlBlock* kcb, int kindIndex, int roleIndex);
+extern roleBitsType getEnabledRoleBits (struct kindControlBlock* kcb, int kindIndex);
 
 extern unsigned int countKinds (struct kindControlBlock* kcb);
 extern unsigned int countRoles (struct kindControlBlock* kcb, int kindIndex);
@@ -168,6 +168,15 @@ typedef struct {
 
 	char *pattern_string;
 
+	/* The regular expression of a built-in parser is compiled into
+	 * PATTERN when the pattern is used first; most parsers initialized
+	 * while processing options never see an input file.  Until then
+	 * REGEX_SRC holds the source.  Both are NULL if compiling
+	 * failed.  Patterns given with --regex-<LANG> and friends are
+	 * compiled when they are defined. */
+	char *regex_src;
+	int cflags;
+
 	char *anonymous_tag_prefix;
 
 	struct {
@@ -296,9 +305,17 @@ static void deletePattern (regexPattern *p)
 	if (p->refcount > 0)
 		return;
 
-	regfree (p->pattern);
-	eFree (p->pattern);
-	p->pattern = NULL;
+	if (p->pattern)
+	{
+		regfree (p->pattern);
+		eFree (p->pattern);
+		p->pattern = NULL;
+	}
+	if (p->regex_src)
+	{
+		eFree (p->regex_src);
+		p->regex_src = NULL;
+	}
 
 	if (p->type == PTRN_TAG)
 	{
@@ -643,12 +660,14 @@ static regexPattern * refPattern (regexPattern * ptrn)
 	return ptrn;
 }
 
-static regexPattern * newPattern (regex_t* const pattern,
+static regexPattern * newPattern (const char* const regex, int cflags,
 								  enum regexParserType regptype)
 {
 	regexPattern *ptrn = xCalloc(1, regexPattern);
 
-	ptrn->pattern = pattern;
+	ptrn->pattern = NULL;
+	ptrn->regex_src = eStrdup (regex);
+	ptrn->cflags = cflags;
 	ptrn->exclusive = false;
 	ptrn->accept_empty_name = false;
 	ptrn->regptype = regptype;
@@ -679,20 +698,20 @@ static regexTableEntry * newRefPatternEntry (regexTableEntry * other)
 	return entry;
 }
 
-static regexTableEntry * newEntry (regex_t* const pattern,
+static regexTableEntry * newEntry (const char* const regex, int cflags,
 								   enum regexParserType regptype)
 {
 	regexTableEntry *entry = xCalloc (1, regexTableEntry);
-	entry->pattern = newPattern (pattern, regptype);
+	entry->pattern = newPattern (regex, cflags, regptype);
 	return entry;
 }
 
-static regexPattern* addCompiledTagCommon (struct lregexControlBlock *lcb,
-										   int table_index,
-										   regex_t* const pattern,
-										   enum regexParserType regptype)
+static regexPattern* addTagPatternCommon (struct lregexControlBlock *lcb,
+										  int table_index,
+										  const char* const regex, int cflags,
+										  enum regexParserType regptype)
 {
-	regexTableEntry *entry = newEntry (pattern, regptype);
+	regexTableEntry *entry = newEntry (regex, cflags, regptype);
 
 	if (regptype == REG_PARSER_MULTI_TABLE)
 	{
@@ -1322,15 +1341,16 @@ static void patternEvalFlags (struct lregexControlBlock *lcb,
 		flagsEval (flags, multitablePtrnFlagDef, ARRAY_SIZE(multitablePtrnFlagDef), &commonFlagData);
 }
 
-static regexPattern *addCompiledTagPattern (struct lregexControlBlock *lcb,
-											int table_index,
-											enum regexParserType regptype, regex_t* const pattern,
+static regexPattern *addTagPattern (struct lregexControlBlock *lcb,
+									int table_index,
+									enum regexParserType regptype,
+									const char* const regex, int cflags,
 					    const char* const name, char kindLetter, const char* kindName,
 					    char *const description, const char* flags,
 					    bool kind_explicitly_defined,
 					    bool *disabled)
 {
-	regexPattern * ptrn = addCompiledTagCommon(lcb, table_index, pattern, regptype);
+	regexPattern * ptrn = addTagPatternCommon(lcb, table_index, regex, cflags, regptype);
 
 	ptrn->type = PTRN_TAG;
 	ptrn->u.tag.name_pattern = eStrdup (name);
@@ -1342,7 +1362,8 @@ static regexPattern *addCompiledTagPattern (struct lregexControlBlock *lcb,
 	return ptrn;
 }
 
-static regexPattern *addCompiledCallbackPattern (struct lregexControlBlock *lcb, regex_t* const pattern,
+static regexPattern *addCallbackPattern (struct lregexControlBlock *lcb,
+					const char* const regex, int cflags,
 					const regexCallback callback, const char* flags,
 					bool *disabled,
 					void *userData)
@@ -1350,7 +1371,7 @@ static regexPattern *addCompiledCallbackPattern (struct lregexControlBlock *lcb,
 	regexPattern * ptrn;
 	bool exclusive = false;
 	flagsEval (flags, prePtrnFlagDef, ARRAY_SIZE(prePtrnFlagDef), &exclusive);
-	ptrn = addCompiledTagCommon(lcb, TABLE_INDEX_UNUSED, pattern, REG_PARSER_SINGLE_LINE);
+	ptrn = addTagPatternCommon(lcb, TABLE_INDEX_UNUSED, regex, cflags, REG_PARSER_SINGLE_LINE);
 	ptrn->type    = PTRN_CALLBACK;
 	ptrn->u.callback.function = callback;
 	ptrn->u.callback.userData = userData;
@@ -1403,21 +1424,24 @@ static flagDefinition regexFlagDefs[] = {
 	  NULL, "applied in a case-insensitive manner"},
 };
 
-static regex_t* compileRegex (enum regexParserType regptype,
-							  const char* const regexp, const char* const flags)
+static int evalRegexFlags (enum regexParserType regptype, const char* const flags)
 {
 	int cflags = REG_EXTENDED | REG_NEWLINE;
 
 	if (regptype == REG_PARSER_MULTI_TABLE)
 		cflags &= ~REG_NEWLINE;
 
-	regex_t *result;
-	int errcode;
-
 	flagsEval (flags,
 		   regexFlagDefs,
 		   ARRAY_SIZE(regexFlagDefs),
 		   &cflags);
+	return cflags;
+}
+
+static regex_t* compileRegex (const char* const regexp, int cflags)
+{
+	regex_t *result;
+	int errcode;
 
 	result = xMalloc (1, regex_t);
 	errcode = regcomp (result, regexp, cflags);
@@ -1433,6 +1457,19 @@ static regex_t* compileRegex (enum regexParserType regptype,
 	return result;
 }
 
+static bool preparePattern (regexPattern *ptrn)
+{
+	if (ptrn->pattern)
+		return true;
+	if (ptrn->regex_src == NULL)
+		return false;
+
+	ptrn->pattern = compileRegex (ptrn->regex_src, ptrn->cflags);
+	eFree (ptrn->regex_src);
+	ptrn->regex_src = NULL;
+	return (ptrn->pattern != NULL);
+}
+
 
 /* If a letter and/or a name are defined in kindSpec, return true. */
 static bool parseKinds (
@@ -1810,6 +1847,9 @@ static bool matchRegexPattern (struct lregexControlBlock *lcb,
 	if (patbuf->disabled && *(patbuf->disabled))
 		return false;
 
+	if (!preparePattern (patbuf))
+		return false;
+
 	match = regexec (patbuf->pattern, vStringValue (line),
 			 BACK_REFERENCE_COUNT, pmatch, 0);
 	if (match == 0)
@@ -1891,6 +1931,9 @@ static bool matchMultilineRegexPattern (struct lregexControlBlock *lcb,
 	if (patbuf->disabled && *(patbuf->disabled))
 		return false;
 
+	if (!preparePattern (patbuf))
+		return false;
+
 	current = start = vStringValue (allLines);
 	do
 	{
@@ -2109,7 +2152,8 @@ static regexPattern *addTagRegexInternal (struct lregexControlBlock *lcb,
 					  const char* const name,
 					  const char* const kinds,
 					  const char* const flags,
-					  bool *disabled)
+					  bool *disabled,
+					  bool compileNow)
 {
 	Assert (regex != NULL);
 	Assert (name != NULL);
@@ -2117,9 +2161,17 @@ static regexPattern *addTagRegexInternal (struct lregexControlBlock *lcb,
 	if (!regexAvailable)
 		return NULL;
 
-	regex_t* const cp = compileRegex (regptype, regex, flags);
-	if (cp == NULL)
-		return NULL;
+	const int cflags = evalRegexFlags (regptype, flags);
+
+	/* A pattern given by the user is compiled here so that a broken
+	 * one is reported at once and defines no kind. */
+	regex_t *cp = NULL;
+	if (compileNow)
+	{
+		cp = compileRegex (regex, cflags);
+		if (cp == NULL)
+			return NULL;
+	}
 
 	char kindLetter;
 	char* kindName;
@@ -2183,12 +2235,18 @@ static regexPattern *addTagRegexInternal (struct lregexControlBlock *lcb,
 		}
 	}
 
-	regexPattern *rptr = addCompiledTagPattern (lcb, table_index,
-												regptype, cp, name,
+	regexPattern *rptr = addTagPattern (lcb, table_index,
+										regptype, regex, cflags, name,
 												kindLetter, kindName, description, flags,
 												explictly_defined,
 												disabled);
 	rptr->pattern_string = escapeRegexPattern(regex);
+	if (cp)
+	{
+		rptr->pattern = cp;
+		eFree (rptr->regex_src);
+		rptr->regex_src = NULL;
+	}
 
 	eFree (kindName);
 	if (description)
@@ -2218,7 +2276,8 @@ extern void addTagRegex (struct lregexControlBlock *lcb,
 			 bool *disabled)
 {
 	addTagRegexInternal (lcb, TABLE_INDEX_UNUSED,
-						 REG_PARSER_SINGLE_LINE, regex, name, kinds, flags, disabled);
+						 REG_PARSER_SINGLE_LINE, regex, name, kinds, flags, disabled,
+						 false);
 }
 
 extern void addTagMultiLineRegex (struct lregexControlBlock *lcb, const char* const regex,
@@ -2226,7 +2285,8 @@ extern void addTagMultiLineRegex (struct lregexControlBlock *lcb, const char* co
 								  bool *disabled)
 {
 	addTagRegexInternal (lcb, TABLE_INDEX_UNUSED,
-						 REG_PARSER_MULTI_LINE, regex, name, kinds, flags, disabled);
+						 REG_PARSER_MULTI_LINE, regex, name, kinds, flags, disabled,
+						 false);
 }
 
 extern void addTagMultiTableRegex(struct lregexControlBlock *lcb,
@@ -2241,7 +2301,7 @@ extern void addTagMultiTableRegex(struct lregexControlBlock *lcb,
 		error (FATAL, "unknown table name: %s", table_name);
 
 	addTagRegexInternal (lcb, table_index, REG_PARSER_MULTI_TABLE, regex, name, kinds, flags,
-						 disabled);
+						 disabled, false);
 }
 
 extern void addCallbackRegex (struct lregexControlBlock *lcb,
@@ -2257,13 +2317,10 @@ extern void addCallbackRegex (struct lregexControlBlock *lcb,
 		return;
 
 
-	regex_t* const cp = compileRegex (REG_PARSER_SINGLE_LINE, regex, flags);
-	if (cp != NULL)
-	{
-		regexPattern *rptr = addCompiledCallbackPattern (lcb, cp, callback, flags,
-														 disabled, userData);
-		rptr->pattern_string = escapeRegexPattern(regex);
-	}
+	const int cflags = evalRegexFlags (REG_PARSER_SINGLE_LINE, flags);
+	regexPattern *rptr = addCallbackPattern (lcb, regex, cflags, callback, flags,
+											 disabled, userData);
+	rptr->pattern_string = escapeRegexPattern(regex);
 }
 
 static void addTagRegexOption (struct lregexControlBlock *lcb,
@@ -2315,7 +2372,7 @@ static void addTagRegexOption (struct lregexControlBlock *lcb,
 
 	if (parseTagRegex (regptype, regex_pat, &name, &kinds, &flags))
 		addTagRegexInternal (lcb, table_index, regptype, regex_pat, name, kinds, flags,
-							 NULL);
+							 NULL, true);
 
 	eFree (regex_pat);
 }
@@ -2632,6 +2689,9 @@ static struct regexTable * matchMultitableRegexTable (struct lregexControlBlock
 		if (ptrn->disabled && *(ptrn->disabled))
 			continue;
 
+		if (!preparePattern (ptrn))
+			continue;
+
 		match = regexec (ptrn->pattern, current,
 						 BACK_REFERENCE_COUNT, pmatch, 0);
 
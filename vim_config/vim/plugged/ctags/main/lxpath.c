@@ -11,6 +11,8 @@
 #include "general.h"  /* must always come first */
 #include "debug.h"
 #include "entry.h"
+#include "field.h"
+#include "lxpath_p.h"
 #include "options.h"
 #include "parse_p.h"
 #include "read.h"
@@ -55,7 +57,9 @@ static void simpleXpathMakeTag (xmlNode *node,
 	tag.lineNumber = XML_GET_LINE (node);
 	tag.filePosition = getInputFilePositionForLine (tag.lineNumber);
 
-	path = (char *)xmlGetNodePath (node);
+	/* xmlGetNodePath () counts the siblings of every ancestor; it is
+	 * quadratic in a flat document with thousands of elements. */
+	path = isFieldEnabled (FIELD_XPATH)? (char *)xmlGetNodePath (node): NULL;
 	tag.extensionFields.xpath = path;
 
 	if (spec->make)
@@ -163,7 +167,8 @@ static xmlDocPtr makeXMLDoc (void)
 	{
 		xmlSetGenericErrorFunc (NULL, suppressWarning);
 		xmlLineNumbersDefault (1);
-		doc = xmlParseMemory((const char*)data, size);
+		doc = xmlReadMemory((const char*)data, size, NULL, NULL,
+				    LXPATH_PARSE_OPTIONS);
 	}
 
 	return doc;
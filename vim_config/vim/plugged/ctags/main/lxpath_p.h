@@ -16,6 +16,27 @@
 
 #include "general.h"  /* must always come first */
 #include "types.h"
+#include "lxpath.h"
+
+/*
+*   MACROS
+*/
+
+#ifdef HAVE_LIBXML
+#include <libxml/parser.h>
+
+/* Options for xmlReadMemory (); XML_PARSE_COMPACT stores short text
+ * nodes inline, XML_PARSE_BIG_LINES keeps line numbers beyond 65535
+ * exact for tags in large files. */
+#ifdef XML_PARSE_BIG_LINES
+#define LXPATH_PARSE_OPTIONS (XML_PARSE_NOERROR|XML_PARSE_NOWARNING	\
+							  |XML_PARSE_NONET|XML_PARSE_COMPACT		\
+							  |XML_PARSE_BIG_LINES)
+#else
+#define LXPATH_PARSE_OPTIONS (XML_PARSE_NOERROR|XML_PARSE_NOWARNING	\
+							  |XML_PARSE_NONET|XML_PARSE_COMPACT)
+#endif
+#endif
 
 
 /*
@@ -54,6 +54,7 @@
 #include "entry_p.h"
 #include "error_p.h"
 #include "field_p.h"
+#include "htable.h"
 #include "keyword_p.h"
 #include "main_p.h"
 #include "options_p.h"
@@ -64,6 +65,7 @@
 #include "stats_p.h"
 #include "trace.h"
 #include "trashbox_p.h"
+#include "vstring.h"
 #include "writer_p.h"
 #include "xtag_p.h"
 
@@ -349,6 +351,9 @@ static void batchMakeTags (cookedArgs *args, void *user CTAGS_ATTR_UNUSED)
 	}
 
 #define timeStamp(n) timeStamps[(n)]=(Option.printTotals ? clock():(clock_t)0)
+	if (Option.printTotals == TOTALS_PROFILE)
+		startProfiling ();
+
 	if ((! Option.filter) && (! Option.printLanguage))
 		openTagFile ();
 
@@ -382,7 +387,7 @@ static void batchMakeTags (cookedArgs *args, void *user CTAGS_ATTR_UNUSED)
 	if (Option.printTotals)
 	{
 		printTotals (timeStamps, Option.append, Option.sorted);
-		if (Option.printTotals > 1)
+		if (Option.printTotals == TOTALS_EXTRA)
 			for (unsigned int i = 0; i < countParsers(); i++)
 				printParserStatisticsIfUsed (i);
 	}
@@ -391,6 +396,169 @@ static void batchMakeTags (cookedArgs *args, void *user CTAGS_ATTR_UNUSED)
 }
 
 #ifdef HAVE_JANSSON
+/* Read a request line of any length, including the trailing newline. */
+static bool readRequestLine (vString *line, FILE *fp)
+{
+	char chunk [1024];
+
+	vStringClear (line);
+	while (fgets (chunk, sizeof (chunk), fp))
+	{
+		vStringCatS (line, chunk);
+		if (vStringLast (line) == '\n')
+			break;
+	}
+	return vStringLength (line) > 0;
+}
+
+static void printCompletion (const char *command, json_t *id)
+{
+	fprintf (stdout, "{\"_type\": \"completed\", \"command\": \"%s\"", command);
+	if (id)
+	{
+		char *str = json_dumps (id, JSON_ENCODE_ANY);
+		if (str)
+		{
+			fprintf (stdout, ", \"id\": %s", str);
+			free (str);
+		}
+	}
+	fputs ("}\n", stdout);
+	/* Flush per request so that a client pipelining several requests
+	 * can consume each response as soon as it is complete. */
+	fflush (stdout);
+}
+
+/* Responses to inline generate-tags requests are cached.  Editors
+ * resend unchanged buffers on focus changes and no-op saves; the
+ * response for the last contents sent under each file name is kept,
+ * and replayed when exactly the same bytes arrive again.  Options
+ * cannot change during an interactive session, so the file name and
+ * the contents are the whole key.  Least recently used entries are
+ * dropped when the cached inputs and outputs exceed the budget. */
+#define RESPONSE_CACHE_BUDGET (16 * 1024 * 1024)
+
+typedef struct sResponseCacheEntry {
+	char *filename;
+	unsigned char *data;
+	size_t size;
+	vString *output;
+	struct sResponseCacheEntry *prev;	/* more recently used */
+	struct sResponseCacheEntry *next;	/* less recently used */
+} responseCacheEntry;
+
+static struct {
+	hashTable *table;			/* filename -> responseCacheEntry */
+	responseCacheEntry *head;
+	responseCacheEntry *tail;
+	size_t bytes;
+} ResponseCache;
+
+static size_t responseCacheEntryBytes (responseCacheEntry *entry)
+{
+	return entry->size + vStringLength (entry->output) + strlen (entry->filename);
+}
+
+static void responseCacheUnlink (responseCacheEntry *entry)
+{
+	if (entry->prev)
+		entry->prev->next = entry->next;
+	else
+		ResponseCache.head = entry->next;
+	if (entry->next)
+		entry->next->prev = entry->prev;
+	else
+		ResponseCache.tail = entry->prev;
+	entry->prev = entry->next = NULL;
+}
+
+static void responseCacheLinkHead (responseCacheEntry *entry)
+{
+	entry->prev = NULL;
+	entry->next = ResponseCache.head;
+	if (ResponseCache.head)
+		ResponseCache.head->prev = entry;
+	ResponseCache.head = entry;
+	if (ResponseCache.tail == NULL)
+		ResponseCache.tail = entry;
+}
+
+static void responseCacheRemove (responseCacheEntry *entry)
+{
+	responseCacheUnlink (entry);
+	hashTableDeleteItem (ResponseCache.table, entry->filename);
+	ResponseCache.bytes -= responseCacheEntryBytes (entry);
+
+	eFree (entry->filename);
+	eFree (entry->data);
+	vStringDelete (entry->output);
+	eFree (entry);
+}
+
+static responseCacheEntry *responseCacheLookup (const char *filename,
+												const unsigned char *data, size_t size)
+{
+	responseCacheEntry *entry;
+
+	if (ResponseCache.table == NULL)
+		return NULL;
+
+	entry = hashTableGetItem (ResponseCache.table, filename);
+	if (entry == NULL
+		|| entry->size != size
+		|| memcmp (entry->data, data, size) != 0)
+		return NULL;
+
+	responseCacheUnlink (entry);
+	responseCacheLinkHead (entry);
+	return entry;
+}
+
+/* Takes the ownership of DATA and OUTPUT. */
+static void responseCacheStore (const char *filename,
+								unsigned char *data, size_t size, vString *output)
+{
+	responseCacheEntry *entry;
+
+	if (ResponseCache.table == NULL)
+		ResponseCache.table = hashTableNew (64, hashCstrhash, hashCstreq, NULL, NULL);
+
+	entry = hashTableGetItem (ResponseCache.table, filename);
+	if (entry)
+		responseCacheRemove (entry);
+
+	entry = xMalloc (1, responseCacheEntry);
+	entry->filename = eStrdup (filename);
+	entry->data = data;
+	entry->size = size;
+	entry->output = output;
+
+	if (responseCacheEntryBytes (entry) > RESPONSE_CACHE_BUDGET)
+	{
+		eFree (entry->filename);
+		eFree (entry->data);
+		vStringDelete (entry->output);
+		eFree (entry);
+		return;
+	}
+
+	hashTablePutItem (ResponseCache.table, entry->filename, entry);
+	responseCacheLinkHead (entry);
+	ResponseCache.bytes += responseCacheEntryBytes (entry);
+
+	while (ResponseCache.bytes > RESPONSE_CACHE_BUDGET)
+		responseCacheRemove (ResponseCache.tail);
+}
+
+static void responseCacheDelete (void)
+{
+	while (ResponseCache.head)
+		responseCacheRemove (ResponseCache.head);
+	if (ResponseCache.table)
+		hashTableDelete (ResponseCache.table);
+	ResponseCache.table = NULL;
+}
+
 void interactiveLoop (cookedArgs *args CTAGS_ATTR_UNUSED, void *user)
 {
 	struct interactiveModeArgs *iargs = user;
@@ -412,18 +580,19 @@ void interactiveLoop (cookedArgs *args CTAGS_ATTR_UNUSED, void *user)
 		}
 	}
 
-	char buffer[1024];
+	vString *buffer = vStringNew ();
 	json_t *request;
 
 	fputs ("{\"_type\": \"program\", \"name\": \"" PROGRAM_NAME "\", \"version\": \"" PROGRAM_VERSION "\"}\n", stdout);
 	fflush (stdout);
 
-	while (fgets (buffer, sizeof(buffer), stdin))
+	while (readRequestLine (buffer, stdin))
 	{
-		if (buffer[0] == '\n')
+		if (vStringChar (buffer, 0) == '\n')
 			continue;
 
-		request = json_loads (buffer, JSON_DISABLE_EOF_CHECK, NULL);
+		request = json_loadb (vStringValue (buffer), vStringLength (buffer),
+							  JSON_DISABLE_EOF_CHECK, NULL);
 		if (! request)
 		{
 			error (FATAL, "invalid json");
@@ -450,9 +619,9 @@ void interactiveLoop (cookedArgs *args CTAGS_ATTR_UNUSED, void *user)
 
 			json_unpack (request, "{sI}", "size", &size);
 
-			openTagFile ();
 			if (size == -1)
 			{					/* read from disk */
+				openTagFile ();
 				if (iargs->sandbox) {
 					error (FATAL,
 						   "invalid request in sandbox submode: reading file contents from a file is limited");
@@ -461,19 +630,41 @@ void interactiveLoop (cookedArgs *args CTAGS_ATTR_UNUSED, void *user)
 				}
 
 				createTagsForEntry (filename);
+				closeTagFile (false);
 			}
 			else
 			{					/* read nbytes from stream */
 				unsigned char *data = eMalloc (size);
 				size = fread (data, 1, size, stdin);
-				MIO *mio = mio_new_memory (data, size, eRealloc, eFreeNoNullCheck);
+
+				responseCacheEntry *entry = responseCacheLookup (filename, data, size);
+				if (entry)
+				{
+					eFree (data);
+					fwrite (vStringValue (entry->output), 1,
+							vStringLength (entry->output), stdout);
+					printCompletion ("generate-tags", json_object_get (request, "id"));
+					goto next;
+				}
+
+				/* Sorted output is not written through the capture. */
+				vString *output = (Option.sorted == SO_UNSORTED)? vStringNew (): NULL;
+				MIO *mio = mio_new_memory (data, size, NULL, NULL);
+
+				openTagFile ();
+				captureTagFileOutput (output);
 				parseFileWithMio (filename, mio, NULL);
 				mio_unref (mio);
+				closeTagFile (false);
+				captureTagFileOutput (NULL);
+
+				if (output)
+					responseCacheStore (filename, data, size, output);
+				else
+					eFree (data);
 			}
 
-			closeTagFile (false);
-			fputs ("{\"_type\": \"completed\", \"command\": \"generate-tags\"}\n", stdout);
-			fflush(stdout);
+			printCompletion ("generate-tags", json_object_get (request, "id"));
 		}
 		else
 		{
@@ -484,6 +675,8 @@ void interactiveLoop (cookedArgs *args CTAGS_ATTR_UNUSED, void *user)
 	next:
 		json_decref (request);
 	}
+	responseCacheDelete ();
+	vStringDelete (buffer);
 }
 #endif
 
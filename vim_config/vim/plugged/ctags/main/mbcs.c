@@ -27,8 +27,34 @@
 #include "mbcs.h"
 #include "mbcs_p.h"
 #include "routines.h"
+#include "vstring.h"
 
+/* The descriptor survives closeConverter () and is reused while files
+ * ask for the same pair of encodings; iconv_open is expensive. */
 static iconv_t iconv_fd = (iconv_t) -1;
+static char *iconv_from;
+static char *iconv_to;
+static bool converting;
+/* true if 7-bit bytes convert to themselves */
+static bool asciiTransparent;
+static vString *convertBuffer;
+
+static bool isAsciiTransparent (void)
+{
+	char src [128], dest [128 * 4];
+	char *src_ptr = src, *dest_ptr = dest;
+	size_t src_len = sizeof (src) - 1, dest_len = sizeof (dest);
+	bool r;
+
+	for (int i = 1; i < 128; i++)
+		src [i - 1] = (char) i;
+
+	r = (iconv (iconv_fd, &src_ptr, &src_len, &dest_ptr, &dest_len) != (size_t) -1
+		 && (dest_ptr - dest) == sizeof (src) - 1
+		 && memcmp (src, dest, sizeof (src) - 1) == 0);
+	iconv (iconv_fd, NULL, NULL, NULL, NULL);
+	return r;
+}
 
 extern bool openConverter (const char* inputEncoding, const char* outputEncoding)
 {
@@ -43,6 +69,16 @@ extern bool openConverter (const char* inputEncoding, const char* outputEncoding
 		}
 		return false;
 	}
+
+	if (iconv_fd != (iconv_t) -1
+		&& strcmp (iconv_from, inputEncoding) == 0
+		&& strcmp (iconv_to, outputEncoding) == 0)
+	{
+		converting = true;
+		return true;
+	}
+
+	freeConverterResources ();
 	iconv_fd = iconv_open(outputEncoding, inputEncoding);
 	if (iconv_fd == (iconv_t) -1)
 	{
@@ -50,26 +86,55 @@ extern bool openConverter (const char* inputEncoding, const char* outputEncoding
 					"failed opening encoding from '%s' to '%s'", inputEncoding, outputEncoding);
 		return false;
 	}
+	iconv_from = eStrdup (inputEncoding);
+	iconv_to = eStrdup (outputEncoding);
+	asciiTransparent = isAsciiTransparent ();
+	converting = true;
 	return true;
 }
 
 extern bool isConverting ()
 {
-	return iconv_fd != (iconv_t) -1;
+	return converting;
+}
+
+/* Stateful encodings switch character sets with 7-bit sequences:
+ * ESC in ISO-2022-*, SO and SI in ISO-2022-KR, '+' in UTF-7, and
+ * '~' in HZ.  A string holding one of them may not convert to itself
+ * even if the encoding passed isAsciiTransparent (). */
+static bool isShiftByte (unsigned char c)
+{
+	return c == 0x1b || c == 0x0e || c == 0x0f || c == '+' || c == '~';
+}
+
+static bool isAscii (const char *s, size_t len)
+{
+	for (size_t i = 0; i < len; i++)
+	{
+		unsigned char c = (unsigned char) s [i];
+		if (c >= 0x80 || isShiftByte (c))
+			return false;
+	}
+	return true;
 }
 
 extern bool convertString (vString *const string)
 {
 	size_t dest_len, src_len;
 	char *dest, *dest_ptr, *src;
-	if (iconv_fd == (iconv_t) -1)
+	if (!converting)
 		return false;
 	src_len = vStringLength (string);
+	if (asciiTransparent && isAscii (vStringValue (string), src_len))
+		return true;
+
 	/* Should be longest length of bytes. so maybe utf8. */
 	dest_len = src_len * 4;
-	dest_ptr = dest = xCalloc (dest_len, char);
-	if (!dest)
-		return false;
+	if (convertBuffer == NULL)
+		convertBuffer = vStringNew ();
+	if (vStringSize (convertBuffer) < dest_len + 1)
+		vStringResize (convertBuffer, dest_len + 1);
+	dest_ptr = dest = vStringValue (convertBuffer);
 	src = vStringValue (string);
 retry:
 	if (iconv (iconv_fd, &src, &src_len, &dest_ptr, &dest_len) == (size_t) -1)
@@ -83,18 +148,13 @@ retry:
 			verbose ("  Encoding: %s\n", strerror(errno));
 			goto retry;
 		}
-		eFree (dest);
+		iconv (iconv_fd, NULL, NULL, NULL, NULL);
 		return false;
 	}
 
 	dest_len = dest_ptr - dest;
-
 	vStringClear (string);
-	if (vStringSize (string) < dest_len + 1)
-		vStringResize (string, dest_len + 1);
-	memcpy (vStringValue (string), dest, dest_len + 1);
-	vStringLength (string) = dest_len;
-	eFree (dest);
+	vStringNCatSUnsafe (string, dest, dest_len);
 
 	iconv (iconv_fd, NULL, NULL, NULL, NULL);
 
@@ -102,12 +162,30 @@ retry:
 }
 
 extern void closeConverter ()
+{
+	converting = false;
+}
+
+extern void freeConverterResources (void)
 {
 	if (iconv_fd != (iconv_t) -1)
 	{
 		iconv_close(iconv_fd);
 		iconv_fd = (iconv_t) -1;
 	}
+	if (iconv_from)
+	{
+		eFree (iconv_from);
+		iconv_from = NULL;
+	}
+	if (iconv_to)
+	{
+		eFree (iconv_to);
+		iconv_to = NULL;
+	}
+	converting = false;
+	vStringDelete (convertBuffer);
+	convertBuffer = NULL;
 }
 
 #endif	/* HAVE_ICONV */
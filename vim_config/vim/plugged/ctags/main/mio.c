@@ -96,6 +96,7 @@ static void eFree (void *const ptr)
 #define MIO_CHUNK_SIZE 4096
 
 #define MAX(a, b)  (((a) > (b)) ? (a) : (b))
+#define MIN(a, b)  (((a) < (b)) ? (a) : (b))
 
 
 /**
@@ -1007,23 +1008,28 @@ char *mio_gets (MIO *mio, char *s, size_t size)
 			size_t buf_size = mio->impl.mem.size;
 			unsigned char *buf = mio->impl.mem.buf;
 
-			if (mio->impl.mem.ungetch != EOF)
+			if (mio->impl.mem.ungetch != EOF && i < (size - 1))
 			{
 				s[i] = (char)mio->impl.mem.ungetch;
 				mio->impl.mem.ungetch = EOF;
 				pos++;
 				i++;
+				newline = (s[0] == '\n');
 			}
-			for (; pos < buf_size && i < (size - 1); i++)
+			if (!newline && pos < buf_size && i < (size - 1))
 			{
-				s[i] = (char)buf[pos];
-				pos++;
-				if (s[i] == '\n')
+				/* Scan and copy the line in bulk. */
+				size_t n = MIN (buf_size - pos, (size - 1) - i);
+				const unsigned char *nl = memchr (buf + pos, '\n', n);
+
+				if (nl)
 				{
-					i++;
+					n = (size_t)(nl - (buf + pos)) + 1;
 					newline = true;
-					break;
 				}
+				memcpy (s + i, buf + pos, n);
+				pos += n;
+				i += n;
 			}
 			if (i > 0)
 			{
@@ -32,6 +32,7 @@
 #include "parse_p.h"
 #include "ptag_p.h"
 #include "routines_p.h"
+#include "stats_p.h"
 #include "xtag_p.h"
 #include "param_p.h"
 #include "error_p.h"
@@ -163,7 +164,7 @@ optionValues Option = {
 	.filter = false,
 	.filterTerminator = NULL,
 	.tagRelative = TREL_NO,
-	.printTotals = 0,
+	.printTotals = TOTALS_NONE,
 	.lineDirectives = false,
 	.printLanguage =false,
 	.guessLanguageEagerly = false,
@@ -255,11 +256,7 @@ static optionDescription LongOptionDescription [] = {
 #else
  {0,0,"       Force output of specified tag file format [2]."},
 #endif
-#ifdef HAVE_JANSSON
- {0,0,"  --output-format=(u-ctags|e-ctags|etags|xref|json)"},
-#else
- {0,0,"  --output-format=(u-ctags|e-ctags|etags|xref)"},
-#endif
+ {0,0,"  --output-format=(u-ctags|e-ctags|etags|xref|json|binary)"},
  {0,0,"      Specify the output format. [u-ctags]"},
  {0,0,"  -e   Output tag file for use with Emacs."},
  {1,0,"  -x   Print a tabular cross reference file to standard output."},
@@ -481,8 +478,9 @@ static optionDescription LongOptionDescription [] = {
  {0,0,"       input file."},
  {1,0,"  --quiet[=(yes|no)]"},
  {0,0,"       Don't print NOTICE class messages [no]."},
- {1,0,"  --totals[=(yes|no|extra)]"},
+ {1,0,"  --totals[=(yes|no|extra|profile)]"},
  {1,0,"       Print statistics about input and tag files [no]."},
+ {1,0,"       profile prints the time spent in each phase and parser as JSON."},
  {1,0,"  --verbose[=(yes|no)]"},
  {1,0,"       Enable verbose messages describing actions on each input file."},
  {1,0,"  --version"},
@@ -582,8 +580,8 @@ static struct Feature {
 #ifdef HAVE_LIBXML
 	{"xpath", "linked with library for parsing xml input"},
 #endif
-#ifdef HAVE_JANSSON
 	{"json", "supports json format output"},
+#ifdef HAVE_JANSSON
 	{"interactive", "accepts source code from stdin"},
 #endif
 #ifdef HAVE_SECCOMP
@@ -764,7 +762,7 @@ extern void checkOptions (void)
 		if (Option.printTotals)
 		{
 			error (WARNING, "%s disables totals", notice);
-			Option.printTotals = 0;
+			Option.printTotals = TOTALS_NONE;
 		}
 		if (Option.tagFileName != NULL)
 			error (WARNING, "%s ignores output tag file name", notice);
@@ -856,7 +854,6 @@ static void setXrefMode (void)
 	setTagWriter (WRITER_XREF, NULL);
 }
 
-#ifdef HAVE_JANSSON
 static void setJsonMode (void)
 {
 	enablePtag (PTAG_JSON_OUTPUT_VERSION, true);
@@ -864,7 +861,12 @@ static void setJsonMode (void)
 	enablePtag (PTAG_FILE_FORMAT, false);
 	setTagWriter (WRITER_JSON, NULL);
 }
-#endif
+
+static void setBinaryMode (void)
+{
+	enablePtag (PTAG_OUTPUT_MODE, false);
+	setTagWriter (WRITER_BINARY, NULL);
+}
 
 /*
  *  Cooked argument parsing
@@ -2417,10 +2419,10 @@ static void processOutputFormat (const char *const option CTAGS_ATTR_UNUSED,
 		setEtagsMode ();
 	else if (strcmp (parameter, "xref") == 0)
 		setXrefMode ();
-#ifdef HAVE_JANSSON
 	else if (strcmp (parameter, "json") == 0)
 		setJsonMode ();
-#endif
+	else if (strcmp (parameter, "binary") == 0)
+		setBinaryMode ();
 	else
 		error (FATAL, "unknown output format name supplied for \"%s=%s\"", option, parameter);
 }
@@ -2529,11 +2531,13 @@ static void processTotals (
 		const char *const option, const char *const parameter)
 {
 	if (isFalse (parameter))
-		Option.printTotals = 0;
+		Option.printTotals = TOTALS_NONE;
 	else if (isTrue (parameter) || *parameter == '\0')
-		Option.printTotals = 1;
+		Option.printTotals = TOTALS_YES;
 	else if (strcasecmp (parameter, "extra") == 0)
-		Option.printTotals = 2;
+		Option.printTotals = TOTALS_EXTRA;
+	else if (strcasecmp (parameter, "profile") == 0)
+		Option.printTotals = TOTALS_PROFILE;
 	else
 		error (FATAL, "Invalid value for \"%s\" option", option);
 }
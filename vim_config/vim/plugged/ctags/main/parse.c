@@ -2242,6 +2242,12 @@ extern bool isLanguageRoleEnabled (const langType language, int kindIndex, int r
 						 kindIndex, roleIndex);
 }
 
+extern roleBitsType getLanguageEnabledRoleBits (const langType language, int kindIndex)
+{
+	return getEnabledRoleBits (LanguageTable [language].kindControlBlock,
+							   kindIndex);
+}
+
 extern bool isLanguageKindRefOnly (const langType language, int kindIndex)
 {
 	kindDefinition * def =  getLanguageKind(language, kindIndex);
@@ -3802,7 +3808,7 @@ static subparser* teardownLanguageSubparsersInUse (const langType language)
 
 static void	initializeParserStats (parserObject *parser)
 {
-	if (Option.printTotals > 1 && parser->used == 0 && parser->def->initStats)
+	if (Option.printTotals == TOTALS_EXTRA && parser->used == 0 && parser->def->initStats)
 		parser->def->initStats (parser->def->id);
 	parser->used = 1;
 }
@@ -3857,6 +3863,7 @@ static bool createTagsWithFallback1 (const langType language,
 		  createTagsForFile (language, ++passCount) )
 		!= RESCAN_NONE)
 	{
+		profileCountRescan ();
 		if (useCork)
 		{
 			uncorkTagFile();
@@ -3944,9 +3951,14 @@ static bool createTagsWithFallback (
 	}
 	*failureInOpenning = false;
 
+	profileEnterPhase (PROFILE_PARSE);
 	tagFileResized = createTagsWithFallback1 (language,
 											  &exclusive_subparser);
+	profileLeavePhase ();
+
+	profileEnterPhase (PROFILE_PROMISE);
 	tagFileResized = forcePromises()? true: tagFileResized;
+	profileLeavePhase ();
 
 	pushLanguage ((exclusive_subparser == LANG_IGNORE)
 				  ? language
@@ -4028,6 +4040,7 @@ extern void freeEncodingResources (void)
 		eFree (Option.inputEncoding);
 	if (Option.outputEncoding)
 		eFree (Option.outputEncoding);
+	freeConverterResources ();
 }
 
 extern const char *getLanguageEncoding (const langType language)
@@ -4130,7 +4143,10 @@ extern bool parseFileWithMio (const char *const fileName, MIO *mio,
 	};
 	memset (&req.mtime, 0, sizeof (req.mtime));
 
+	profileBeginFile ();
+	profileEnterPhase (PROFILE_GUESS);
 	language = getFileLanguageForRequest (&req);
+	profileLeavePhase ();
 	Assert (language != LANG_AUTO);
 
 	if (Option.printLanguage)
@@ -4157,6 +4173,7 @@ extern bool parseFileWithMio (const char *const fileName, MIO *mio,
 		if (Option.filter && ! Option.interactive)
 			closeTagFile (tagFileResized);
 		addTotals (1, 0L, 0L);
+		profileEndFile (fileName, language);
 
 #ifdef HAVE_ICONV
 		closeConverter ();
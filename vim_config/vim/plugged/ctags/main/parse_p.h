@@ -77,6 +77,7 @@ extern int defineLanguageKind (const langType language, kindDefinition *def,
 
 extern unsigned int countLanguageKinds (const langType language);
 extern unsigned int countLanguageRoles (const langType language, int kindIndex);
+extern roleBitsType getLanguageEnabledRoleBits (const langType language, int kindIndex);
 
 extern bool isLanguageKindRefOnly (const langType language, int kindIndex);
 
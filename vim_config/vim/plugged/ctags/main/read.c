@@ -83,6 +83,16 @@ typedef struct sNestedInputStreamInfo {
 	long endCharOffset;
 } nestedInputStreamInfo;
 
+/*  Input files arrive directory by directory, and the part of tagPath
+ *  made from the directory of an input file does not depend on the
+ *  base name of the file. The rendering of the last directory is kept
+ *  here so relativeFilename and absoluteFilename run once per directory.
+ */
+typedef struct sTagPathCache {
+	vString *dir;            /* directory part of the input file name */
+	vString *prefix;         /* how DIR is rendered in tagPath */
+} tagPathCache;
+
 typedef struct sInputFile {
 	vString    *path;          /* path of input file (if any) */
 	vString    *line;          /* last line read from file */
@@ -135,6 +145,7 @@ static void     langStackClear(langStack *langStack);
 static inputFile File;  /* static read through functions */
 static inputFile BackupFile;	/* File is copied here when a nested parser is pushed */
 static compoundPos StartOfLine;  /* holds deferred position of start of line */
+static tagPathCache TagPathCache;
 
 /*
 *   FUNCTION DEFINITIONS
@@ -287,6 +298,8 @@ extern void freeInputFileResources (void)
 		vStringDelete (File.line);
 	freeInputFileInfo (&File.input);
 	freeInputFileInfo (&File.source);
+	vStringDelete (TagPathCache.dir);
+	vStringDelete (TagPathCache.prefix);
 }
 
 extern const unsigned char *getInputFileData (size_t *size)
@@ -391,6 +404,52 @@ static void setOwnerDirectoryOfInputFile (const char *const fileName)
 	}
 }
 
+static char *renderTagPathFull (const char *const fileName)
+{
+	if (Option.tagRelative == TREL_NEVER)
+		return absoluteFilename (fileName);
+	return relativeFilename (fileName, getTagFileDirectory ());
+}
+
+static vString *renderTagPath (vString *const fileName)
+{
+	const char *const name = vStringValue (fileName);
+	const char *const base = baseFilename (name);
+	const size_t dirLen = base - name;
+	size_t baseLen, fullLen;
+	char *full;
+
+	if (dirLen == 0 || strcmp (base, ".") == 0 || strcmp (base, "..") == 0)
+		return vStringNewOwn (renderTagPathFull (name));
+
+	if (TagPathCache.dir
+		&& vStringLength (TagPathCache.dir) == dirLen
+		&& strncmp (vStringValue (TagPathCache.dir), name, dirLen) == 0)
+	{
+		vString *tagPath = vStringNewCopy (TagPathCache.prefix);
+		vStringCatS (tagPath, base);
+		return tagPath;
+	}
+
+	full = renderTagPathFull (name);
+	fullLen = strlen (full);
+	baseLen = strlen (base);
+	if (fullLen >= baseLen && strcmp (full + fullLen - baseLen, base) == 0)
+	{
+		if (TagPathCache.dir == NULL)
+		{
+			TagPathCache.dir = vStringNew ();
+			TagPathCache.prefix = vStringNew ();
+		}
+		vStringNCopyS (TagPathCache.dir, name, dirLen);
+		vStringNCopyS (TagPathCache.prefix, full, fullLen - baseLen);
+	}
+	else if (TagPathCache.dir)
+		vStringClear (TagPathCache.dir);
+
+	return vStringNewOwn (full);
+}
+
 static void setInputFileParametersCommon (inputFileInfo *finfo, vString *const fileName,
 					  const langType language,
 					  stringList *holder)
@@ -407,21 +466,11 @@ static void setInputFileParametersCommon (inputFileInfo *finfo, vString *const f
 			vStringDelete (finfo->tagPath);
 	}
 
-	if (0)
-		;
-	else if (  Option.tagRelative == TREL_ALWAYS )
-		finfo->tagPath =
-			vStringNewOwn (relativeFilename (vStringValue (fileName),
-							 getTagFileDirectory ()));
-	else if ( Option.tagRelative == TREL_NEVER )
-		finfo->tagPath =
-			vStringNewOwn (absoluteFilename (vStringValue (fileName)));
-	else if ( Option.tagRelative == TREL_NO || isAbsolutePath (vStringValue (fileName)) )
+	if ( Option.tagRelative == TREL_NO
+		 || ( Option.tagRelative == TREL_YES && isAbsolutePath (vStringValue (fileName)) ) )
 		finfo->tagPath = vStringNewCopy (fileName);
 	else
-		finfo->tagPath =
-			vStringNewOwn (relativeFilename (vStringValue (fileName),
-							 getTagFileDirectory ()));
+		finfo->tagPath = renderTagPath (fileName);
 
 	finfo->isHeader = isIncludeFile (vStringValue (fileName));
 }
@@ -14,8 +14,10 @@
 #include <string.h>
 
 #include "debug.h"
+#include "lxpath_p.h"
 #include "parse_p.h"
 #include "options.h"
+#include "routines.h"
 #include "selectors.h"
 #include "vstring.h"
 
@@ -170,17 +172,72 @@ selectByObjectiveCAndMatLabKeywords (MIO * input,
 			  NULL, NULL);
 }
 
+/* An Objective-C header announces itself near its top with #import or
+   @interface.  Scanning the rest of a C or C++ header, which is the
+   common case, finds nothing and only delays the parser. */
+#define OBJC_SELECTOR_SCAN_LIMIT (64 * 1024)
+
+static const char *objcMarkers [] = {
+    "#import",
+    "@interface ",
+    "@implementation ",
+    "@protocol ",
+};
+
+static bool
+startsWithObjectiveCMarker (const char *line, size_t len)
+{
+    for (size_t i = 0; i < ARRAY_SIZE (objcMarkers); i++)
+    {
+	size_t mlen = strlen (objcMarkers[i]);
+	if (mlen <= len && memcmp (line, objcMarkers[i], mlen) == 0)
+	    return true;
+    }
+    return false;
+}
+
 static const char *
-tasteObjectiveC (const char *line, void *data CTAGS_ATTR_UNUSED)
+tasteObjectiveC (const char *line, void *data)
 {
-    if (startsWith (line, "#import")
-	|| startsWith (line, "@interface ")
-	|| startsWith (line, "@implementation ")
-	|| startsWith (line, "@protocol "))
+    size_t *scanned = data;
+
+    if (startsWithObjectiveCMarker (line, strlen (line)))
 	return TR_OBJC;
+
+    *scanned += strlen (line);
+    if (*scanned >= OBJC_SELECTOR_SCAN_LIMIT)
+	return TR_CPP;
     return NULL;
 }
 
+/* Same as selectByLines with tasteObjectiveC but works on the buffer
+   of a memory stream directly.  Only lines starting with '#' or '@'
+   can hold a marker, so most of the lines are skipped with memchr. */
+static const char *
+selectObjectiveCInMemory (const unsigned char *data, size_t size)
+{
+    const char *p = (const char *)data;
+    const char *end;
+
+    if (size > OBJC_SELECTOR_SCAN_LIMIT)
+	size = OBJC_SELECTOR_SCAN_LIMIT;
+    end = p + size;
+
+    while (p < end)
+    {
+	const char *nl = memchr (p, '\n', end - p);
+	const char *eol = nl? nl: end;
+
+	if ((*p == '#' || *p == '@')
+	    && startsWithObjectiveCMarker (p, eol - p))
+	    return TR_OBJC;
+	if (!nl)
+	    break;
+	p = nl + 1;
+    }
+    return TR_CPP;
+}
+
 const char *
 selectByObjectiveCKeywords (MIO * input,
 							langType *candidates CTAGS_ATTR_UNUSED,
@@ -206,8 +263,16 @@ selectByObjectiveCKeywords (MIO * input,
     else if (! isLanguageEnabled (cpp))
 	return TR_OBJC;
 
+    unsigned char *data;
+    size_t size;
+    size_t scanned = 0;
+
+    data = mio_memory_get_data (input, &size);
+    if (data)
+	return selectObjectiveCInMemory (data, size);
+
     return selectByLines (input, tasteObjectiveC, TR_CPP,
-			  NULL);
+			  &scanned);
 }
 
 static const char *
@@ -321,7 +386,8 @@ xmlParseMIO (MIO *input)
 
 	xmlSetGenericErrorFunc (NULL, suppressWarning);
 	xmlLineNumbersDefault (1);
-	return xmlParseMemory((const char *)buf, len);
+	return xmlReadMemory((const char *)buf, len, NULL, NULL,
+			     LXPATH_PARSE_OPTIONS);
 }
 
 static bool
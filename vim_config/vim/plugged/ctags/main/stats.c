@@ -16,9 +16,15 @@
 #include "general.h"  /* must always come first */
 
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 
+#include "debug.h"
 #include "entry_p.h"
 #include "options_p.h"
+#include "parse.h"
+#include "parse_p.h"
+#include "routines.h"
 #include "stats_p.h"
 
 /*
@@ -26,11 +32,64 @@
 */
 #define plural(value)  (((unsigned long)(value) == 1L) ? "" : "s")
 
+#define PROFILE_STACK_DEPTH   32
+#define PROFILE_SLOWEST_FILES 10
+
+/*
+*   DATA DECLARATIONS
+*/
+typedef struct sLanguageProfile {
+	unsigned long files;
+	unsigned long lines;
+	unsigned long bytes;
+	unsigned long tags;
+	unsigned long rescans;
+	double seconds;
+} languageProfile;
+
+typedef struct sFileProfile {
+	char *name;
+	langType language;
+	double seconds;
+} fileProfile;
+
 /*
 *   DATA DEFINITIONS
 */
 static struct { long files, lines, bytes; } Totals = { 0, 0, 0 };
 
+static const char *const ProfilePhaseNames [PROFILE_PHASE_COUNT] = {
+	[PROFILE_GUESS]   = "guess",
+	[PROFILE_PARSE]   = "parse",
+	[PROFILE_PROMISE] = "promise",
+	[PROFILE_UNCORK]  = "uncork",
+	[PROFILE_PATTERN] = "pattern",
+	[PROFILE_WRITE]   = "write",
+	[PROFILE_SORT]    = "sort",
+};
+
+static struct {
+	bool enabled;
+	double start;
+	double mark;				/* when the time was last charged to a phase */
+	double phases [PROFILE_PHASE_COUNT];
+	profilePhase stack [PROFILE_STACK_DEPTH];
+	unsigned int depth;
+	unsigned int overflow;		/* phases entered beyond PROFILE_STACK_DEPTH */
+
+	/* The file being parsed */
+	double fileStart;
+	unsigned long fileTags;
+	unsigned long fileLines;
+	unsigned long fileBytes;
+	unsigned long fileRescans;
+
+	languageProfile *languages;
+	unsigned int languageCount;
+	fileProfile slowest [PROFILE_SLOWEST_FILES];
+	unsigned int slowestCount;
+} Profile;
+
 
 /*
 *   FUNCTION DEFINITIONS
@@ -42,6 +101,232 @@ extern void addTotals (
 	Totals.files += files;
 	Totals.lines += lines;
 	Totals.bytes += bytes;
+
+	if (Profile.enabled)
+	{
+		Profile.fileLines += lines;
+		Profile.fileBytes += bytes;
+	}
+}
+
+/* A monotonic wall clock is preferred; clock () measures CPU time and
+ * so misses the time spent waiting for I/O. */
+static double profileClock (void)
+{
+#if defined (HAVE_CLOCK_GETTIME) && defined (CLOCK_MONOTONIC)
+	struct timespec ts;
+
+	if (clock_gettime (CLOCK_MONOTONIC, &ts) == 0)
+		return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+#endif
+	return ((double) clock ()) / CLOCKS_PER_SEC;
+}
+
+static void chargeCurrentPhase (double now)
+{
+	if (Profile.depth > 0)
+		Profile.phases [Profile.stack [Profile.depth - 1]] += now - Profile.mark;
+	Profile.mark = now;
+}
+
+extern void startProfiling (void)
+{
+	Profile.enabled = true;
+	Profile.start = profileClock ();
+	Profile.mark = Profile.start;
+}
+
+extern void profileEnterPhase (profilePhase phase)
+{
+	if (!Profile.enabled)
+		return;
+
+	if (Profile.depth == PROFILE_STACK_DEPTH)
+	{
+		Profile.overflow++;
+		return;
+	}
+
+	chargeCurrentPhase (profileClock ());
+	Profile.stack [Profile.depth++] = phase;
+}
+
+extern void profileLeavePhase (void)
+{
+	if (!Profile.enabled)
+		return;
+
+	if (Profile.overflow > 0)
+	{
+		Profile.overflow--;
+		return;
+	}
+
+	Assert (Profile.depth > 0);
+	chargeCurrentPhase (profileClock ());
+	Profile.depth--;
+}
+
+extern void profileBeginFile (void)
+{
+	if (!Profile.enabled)
+		return;
+
+	Profile.fileStart = profileClock ();
+	Profile.fileTags = numTagsAdded ();
+	Profile.fileLines = 0;
+	Profile.fileBytes = 0;
+	Profile.fileRescans = 0;
+}
+
+extern void profileCountRescan (void)
+{
+	if (Profile.enabled)
+		Profile.fileRescans++;
+}
+
+static void rememberSlowFile (const char *const fileName, langType language,
+							  double seconds)
+{
+	unsigned int i;
+
+	if (Profile.slowestCount == PROFILE_SLOWEST_FILES)
+	{
+		if (seconds <= Profile.slowest [PROFILE_SLOWEST_FILES - 1].seconds)
+			return;
+		eFree (Profile.slowest [--Profile.slowestCount].name);
+	}
+
+	/* Keep the list sorted in descending order of time. */
+	for (i = Profile.slowestCount; i > 0; i--)
+	{
+		if (Profile.slowest [i - 1].seconds >= seconds)
+			break;
+		Profile.slowest [i] = Profile.slowest [i - 1];
+	}
+	Profile.slowest [i].name = eStrdup (fileName);
+	Profile.slowest [i].language = language;
+	Profile.slowest [i].seconds = seconds;
+	Profile.slowestCount++;
+}
+
+extern void profileEndFile (const char *const fileName, langType language)
+{
+	languageProfile *lp;
+	double seconds;
+
+	if (!Profile.enabled)
+		return;
+
+	Assert (language >= 0);
+	if ((unsigned int) language >= Profile.languageCount)
+	{
+		unsigned int count = countParsers ();
+
+		Assert ((unsigned int) language < count);
+		Profile.languages = xRealloc (Profile.languages, count, languageProfile);
+		memset (Profile.languages + Profile.languageCount, 0,
+				sizeof (languageProfile) * (count - Profile.languageCount));
+		Profile.languageCount = count;
+	}
+
+	seconds = profileClock () - Profile.fileStart;
+
+	lp = Profile.languages + language;
+	lp->files++;
+	lp->lines += Profile.fileLines;
+	lp->bytes += Profile.fileBytes;
+	lp->tags += numTagsAdded () - Profile.fileTags;
+	lp->rescans += Profile.fileRescans;
+	lp->seconds += seconds;
+
+	rememberSlowFile (fileName, language, seconds);
+}
+
+static void printJsonString (const char *s)
+{
+	fputc ('"', stderr);
+	for (; *s; s++)
+	{
+		unsigned char c = (unsigned char) *s;
+
+		if (c == '"' || c == '\\')
+			fprintf (stderr, "\\%c", c);
+		else if (c < 0x20)
+			fprintf (stderr, "\\u%04x", c);
+		else
+			fputc (c, stderr);
+	}
+	fputc ('"', stderr);
+}
+
+/* Print the profile as a JSON object so that it can be processed by
+ * other tools. */
+static void printProfile (void)
+{
+	double elapsed, other;
+	unsigned int i;
+	bool first;
+
+	chargeCurrentPhase (profileClock ());
+	elapsed = Profile.mark - Profile.start;
+
+	fprintf (stderr, "{\n");
+	fprintf (stderr, "  \"files\": %ld,\n", Totals.files);
+	fprintf (stderr, "  \"lines\": %ld,\n", Totals.lines);
+	fprintf (stderr, "  \"bytes\": %ld,\n", Totals.bytes);
+	fprintf (stderr, "  \"tags\": %lu,\n", numTagsAdded ());
+	fprintf (stderr, "  \"elapsed\": %.6f,\n", elapsed);
+
+	fprintf (stderr, "  \"phases\": {");
+	other = elapsed;
+	for (i = 0; i < PROFILE_PHASE_COUNT; i++)
+	{
+		fprintf (stderr, "%s\n    \"%s\": %.6f", i? ",": "",
+				 ProfilePhaseNames [i], Profile.phases [i]);
+		other -= Profile.phases [i];
+	}
+	fprintf (stderr, ",\n    \"other\": %.6f\n  },\n", other > 0.0? other: 0.0);
+
+	fprintf (stderr, "  \"languages\": {");
+	first = true;
+	for (i = 0; i < Profile.languageCount; i++)
+	{
+		const languageProfile *lp = Profile.languages + i;
+
+		if (lp->files == 0)
+			continue;
+
+		fprintf (stderr, "%s\n    ", first? "": ",");
+		printJsonString (getLanguageName (i));
+		fprintf (stderr, ": {\"files\": %lu, \"lines\": %lu, \"bytes\": %lu,"
+				 " \"tags\": %lu, \"rescans\": %lu, \"seconds\": %.6f}",
+				 lp->files, lp->lines, lp->bytes,
+				 lp->tags, lp->rescans, lp->seconds);
+		first = false;
+	}
+	fprintf (stderr, "%s},\n", first? "": "\n  ");
+
+	fprintf (stderr, "  \"slowest\": [");
+	for (i = 0; i < Profile.slowestCount; i++)
+	{
+		const fileProfile *fp = Profile.slowest + i;
+
+		fprintf (stderr, "%s\n    {\"file\": ", i? ",": "");
+		printJsonString (fp->name);
+		fprintf (stderr, ", \"language\": ");
+		printJsonString (getLanguageName (fp->language));
+		fprintf (stderr, ", \"seconds\": %.6f}", fp->seconds);
+		eFree (fp->name);
+	}
+	fprintf (stderr, "%s]\n", Profile.slowestCount? "\n  ": "");
+	fprintf (stderr, "}\n");
+
+	Profile.slowestCount = 0;
+	if (Profile.languages)
+		eFree (Profile.languages);
+	Profile.languages = NULL;
+	Profile.languageCount = 0;
 }
 
 extern void printTotals (const clock_t *const timeStamps, bool append, sortType sorted)
@@ -49,6 +334,12 @@ extern void printTotals (const clock_t *const timeStamps, bool append, sortType
 	const unsigned long totalTags = numTagsTotal();
 	const unsigned long addedTags = numTagsAdded();
 
+	if (Profile.enabled)
+	{
+		printProfile ();
+		return;
+	}
+
 	fprintf (stderr, "%ld file%s, %ld line%s (%ld kB) scanned",
 			Totals.files, plural (Totals.files),
 			Totals.lines, plural (Totals.lines),
@@ -18,6 +18,34 @@
 */
 #include "general.h"  /* must always come first */
 #include "options_p.h"
+#include "types.h"
+
+/*
+*   MACROS
+*/
+
+/* Values for Option.printTotals */
+#define TOTALS_NONE    0
+#define TOTALS_YES     1
+#define TOTALS_EXTRA   2
+#define TOTALS_PROFILE 3
+
+/*
+*   DATA DECLARATIONS
+*/
+
+/* Phases measured with --totals=profile. Time spent in a nested phase
+ * is not counted in the enclosing phase. */
+typedef enum eProfilePhase {
+	PROFILE_GUESS,				/* guessing the language of a file */
+	PROFILE_PARSE,				/* running the parser for a file */
+	PROFILE_PROMISE,			/* running guest parsers for promises */
+	PROFILE_UNCORK,				/* flushing the cork queue */
+	PROFILE_PATTERN,			/* rendering search patterns */
+	PROFILE_WRITE,				/* writing tags */
+	PROFILE_SORT,				/* sorting the tag file */
+	PROFILE_PHASE_COUNT,
+} profilePhase;
 
 /*
 *   FUNCTION PROTOTYPES
@@ -25,4 +53,11 @@
 extern void addTotals (const unsigned int files, const long unsigned int lines, const long unsigned int bytes);
 extern void printTotals (const clock_t *const timeStamps, bool append, sortType sorted);
 
+extern void startProfiling (void);
+extern void profileEnterPhase (profilePhase phase);
+extern void profileLeavePhase (void);
+extern void profileBeginFile (void);
+extern void profileCountRescan (void);
+extern void profileEndFile (const char *const fileName, langType language);
+
 #endif  /* CTAGS_MAIN_STATS_PRIVATE_H */
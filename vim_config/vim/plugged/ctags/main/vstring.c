@@ -26,6 +26,12 @@
 */
 static const size_t vStringInitialSize = 32;
 
+/* vStringNew allocates a vString and its first vStringInitialSize
+ * bytes of buffer in one block; the buffer starts right after the
+ * struct.  Most strings are identifiers and never outgrow it. */
+#define vStringInlineBuffer(vs) ((char *)((vs) + 1))
+#define vStringIsBufferInline(vs) ((vs)->buffer == vStringInlineBuffer (vs))
+
 /*
 *   FUNCTION DEFINITIONS
 */
@@ -43,8 +49,15 @@ extern void vStringResize (vString *const string, const size_t newSize)
 
 	if (size > string->size)
 	{
+		if (vStringIsBufferInline (string))
+		{
+			char *buffer = xMalloc (size, char);
+			memcpy (buffer, string->buffer, string->size);
+			string->buffer = buffer;
+		}
+		else
+			string->buffer = xRealloc (string->buffer, size, char);
 		string->size = size;
-		string->buffer = xRealloc (string->buffer, size, char);
 	}
 }
 
@@ -61,7 +74,7 @@ extern void vStringDelete (vString *const string)
 {
 	if (string != NULL)
 	{
-		if (string->buffer != NULL)
+		if (string->buffer != NULL && !vStringIsBufferInline (string))
 			eFree (string->buffer);
 		eFree (string);
 	}
@@ -69,11 +82,11 @@ extern void vStringDelete (vString *const string)
 
 extern vString *vStringNew (void)
 {
-	vString *const string = xMalloc (1, vString);
+	vString *const string = eMalloc (sizeof (vString) + vStringInitialSize);
 
 	string->length = 0;
 	string->size   = vStringInitialSize;
-	string->buffer = xMalloc (string->size, char);
+	string->buffer = vStringInlineBuffer (string);
 
 	vStringClear (string);
 
@@ -271,7 +284,10 @@ extern char    *vStringDeleteUnwrap       (vString *const string)
 
 	if (string != NULL)
 	{
-		buffer = string->buffer;
+		if (vStringIsBufferInline (string))
+			buffer = vStringStrdup (string);
+		else
+			buffer = string->buffer;
 		string->buffer = NULL;
 
 		string->size = 0;
@@ -0,0 +1,702 @@
+/*
+*   Copyright (c) 2026, Universal Ctags Team
+*
+*   This source code is released for free distribution under the terms of the
+*   GNU General Public License version 2 or (at your option) any later version.
+*
+*   Writer for the binary tag file format.
+*
+*   All tags are kept in memory, and the file is written when the tag
+*   file is closed. All integers in the file are unsigned, 32 bits wide,
+*   and stored in little endian.
+*
+*   header:  BINARY_TAGS_MAGIC (8 bytes), version, sort method, and then
+*            (offset, count) pairs for the sections below in this order.
+*   strings: NUL terminated strings. A string is referred to with its
+*            offset in this section. The offset 0 is for the empty string.
+*   ptags:   records for pseudo tags.
+*   tags:    records for tags. A record has 8 integers: name, input file,
+*            address, line number, kind (0 for no kind), flags, the first
+*            extension field, and the number of extension fields.
+*            The address is the same as the third column of a u-ctags
+*            tag file.
+*   fields:  key and value pairs for the extension fields.
+*   index:   indexes of the tag records sorted by name with strcmp.
+*   findex:  the same as index but names are compared with their case
+*            folded by toupper.
+*
+*   The name of a tag and the values of fields are stored without escaping.
+*   libreadtags reads the format with the same API as for the text formats.
+*/
+
+#include "general.h"  /* must always come first */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "debug.h"
+#include "entry_p.h"
+#include "field.h"
+#include "field_p.h"
+#include "htable.h"
+#include "kind.h"
+#include "mio.h"
+#include "options_p.h"
+#include "parse_p.h"
+#include "ptag_p.h"
+#include "routines.h"
+#include "vstring.h"
+#include "writer_p.h"
+
+
+#define BINARY_TAGS_FILE    "tags.bin"
+#define BINARY_TAGS_VERSION 1
+
+enum binarySection {
+	SECTION_STRINGS,
+	SECTION_PTAGS,
+	SECTION_TAGS,
+	SECTION_FIELDS,
+	SECTION_INDEX,
+	SECTION_FINDEX,
+	SECTION_COUNT,
+};
+
+#define HEADER_SIZE (8 + 4 * 2 + 4 * 2 * SECTION_COUNT)
+
+enum binaryRecordFlag {
+	RECORD_FILE_SCOPE = 1 << 0,
+	RECORD_PSEUDO     = 1 << 1,
+};
+
+typedef struct sBinaryRecord {
+	uint32_t name;
+	uint32_t file;
+	uint32_t address;
+	uint32_t line;
+	uint32_t kind;
+	uint32_t flags;
+	uint32_t field;
+	uint32_t fieldCount;
+} binaryRecord;
+
+typedef struct sBinaryField {
+	uint32_t key;
+	uint32_t value;
+} binaryField;
+
+static struct sBinaryTags {
+	char *strings;
+	size_t stringsLength;
+	size_t stringsSize;
+	hashTable *stringTable;
+
+	binaryRecord *records;
+	size_t recordCount;
+	size_t recordSize;
+
+	binaryField *fields;
+	size_t fieldCount;
+	size_t fieldSize;
+} BinaryTags;
+
+static int writeBinaryEntry (tagWriter *writer CTAGS_ATTR_UNUSED,
+							 MIO * mio, const tagEntryInfo *const tag,
+							 void *clientData);
+static int writeBinaryPtagEntry (tagWriter *writer CTAGS_ATTR_UNUSED,
+								 MIO * mio, const ptagDesc *desc,
+								 const char *const fileName,
+								 const char *const pattern,
+								 const char *const parserName,
+								 void *clientData);
+static void rescanFailedBinaryEntry (tagWriter *writer CTAGS_ATTR_UNUSED,
+									 unsigned long validTagNum,
+									 void *clientData CTAGS_ATTR_UNUSED);
+static void finalizeBinaryOutput (tagWriter *writer CTAGS_ATTR_UNUSED,
+								  MIO * mio,
+								  void *clientData CTAGS_ATTR_UNUSED);
+static void checkBinaryOptions (tagWriter *writer CTAGS_ATTR_UNUSED,
+								bool fieldsWereReset CTAGS_ATTR_UNUSED);
+
+tagWriter binaryWriter = {
+	.writeEntry = writeBinaryEntry,
+	.writePtagEntry = writeBinaryPtagEntry,
+	.printPtagByDefault = true,
+	.preWriteEntry = NULL,
+	.postWriteEntry = NULL,
+	.rescanFailedEntry = rescanFailedBinaryEntry,
+	.treatFieldAsFixed = NULL,
+	.checkOptions = checkBinaryOptions,
+	.finalizeOutput = finalizeBinaryOutput,
+	.binaryOutput = true,
+	.defaultFileName = BINARY_TAGS_FILE,
+};
+
+static void prepareStringTable (void)
+{
+	if (BinaryTags.stringTable)
+		return;
+
+	BinaryTags.stringTable = hashTableNew (1021, hashCstrhash, hashCstreq,
+										   eFree, NULL);
+	/* Offset 0 is for the empty string. */
+	BinaryTags.stringsSize = 4096;
+	BinaryTags.strings = xMalloc (BinaryTags.stringsSize, char);
+	BinaryTags.strings [0] = '\0';
+	BinaryTags.stringsLength = 1;
+}
+
+static uint32_t internString (const char *str)
+{
+	if (str == NULL || str[0] == '\0')
+		return 0;
+
+	prepareStringTable ();
+
+	void *offset = hashTableGetItem (BinaryTags.stringTable, str);
+	if (offset)
+		return (uint32_t)HT_PTR_TO_UINT(offset);
+
+	size_t len = strlen (str) + 1;
+	if (BinaryTags.stringsLength + len > UINT32_MAX)
+		error (FATAL, "too large string table for the binary tag file");
+	if (BinaryTags.stringsLength + len > BinaryTags.stringsSize)
+	{
+		while (BinaryTags.stringsLength + len > BinaryTags.stringsSize)
+			BinaryTags.stringsSize *= 2;
+		BinaryTags.strings = xRealloc (BinaryTags.strings,
+									   BinaryTags.stringsSize, char);
+	}
+
+	uint32_t r = (uint32_t)BinaryTags.stringsLength;
+	memcpy (BinaryTags.strings + r, str, len);
+	BinaryTags.stringsLength += len;
+	hashTablePutItem (BinaryTags.stringTable, eStrdup (str), HT_UINT_TO_PTR(r));
+	return r;
+}
+
+static const char *stringAt (uint32_t offset)
+{
+	return BinaryTags.strings + offset;
+}
+
+static binaryRecord *newRecord (void)
+{
+	if (BinaryTags.recordCount == BinaryTags.recordSize)
+	{
+		BinaryTags.recordSize = BinaryTags.recordSize? BinaryTags.recordSize * 2: 1024;
+		BinaryTags.records = xRealloc (BinaryTags.records,
+									   BinaryTags.recordSize, binaryRecord);
+	}
+
+	binaryRecord *r = BinaryTags.records + BinaryTags.recordCount++;
+	memset (r, 0, sizeof (*r));
+	r->field = (uint32_t)BinaryTags.fieldCount;
+	return r;
+}
+
+static void addField (binaryRecord *r, const char *key, const char *value)
+{
+	if (BinaryTags.fieldCount == BinaryTags.fieldSize)
+	{
+		BinaryTags.fieldSize = BinaryTags.fieldSize? BinaryTags.fieldSize * 2: 1024;
+		BinaryTags.fields = xRealloc (BinaryTags.fields,
+									  BinaryTags.fieldSize, binaryField);
+	}
+
+	binaryField *f = BinaryTags.fields + BinaryTags.fieldCount++;
+	f->key = internString (key);
+	f->value = internString (value);
+	r->fieldCount++;
+}
+
+static const char *renderValue (const tagEntryInfo *tag, fieldType ftype, int index)
+{
+	if (doesFieldHaveRenderer (ftype, true))
+		return renderFieldNoEscaping (ftype, tag, index);
+	return renderField (ftype, tag, index);
+}
+
+static uint32_t internAddress (const tagEntryInfo *const tag)
+{
+	static vString *address;
+
+	address = vStringNewOrClearWithAutoRelease (address);
+
+	/* The same as the third column of u-ctags output. */
+	if (tag->lineNumberEntry && Option.lineDirectives)
+		vStringCatS (address, renderField (FIELD_LINE_NUMBER, tag, NO_PARSER_FIELD));
+	else if (tag->lineNumberEntry)
+	{
+		char buf [32];
+		snprintf (buf, sizeof (buf), "%lu", tag->lineNumber);
+		vStringCatS (address, buf);
+	}
+	else
+	{
+		if (Option.locate == EX_COMBINE)
+		{
+			char buf [32];
+			snprintf (buf, sizeof (buf), "%lu;", tag->lineNumber);
+			vStringCatS (address, buf);
+		}
+		vStringCatS (address, renderField (FIELD_PATTERN, tag, NO_PARSER_FIELD));
+	}
+
+	return internString (vStringValue (address));
+}
+
+static const char *getKindString (const tagEntryInfo *const tag, char letter[2])
+{
+	kindDefinition *kdef = getLanguageKind(tag->langType, tag->kindIndex);
+
+	letter [0] = kdef->letter;
+	letter [1] = '\0';
+
+	if (kdef->name != NULL && (isFieldEnabled (FIELD_KIND_LONG)  ||
+		 (isFieldEnabled (FIELD_KIND)  && kdef->letter == KIND_NULL_LETTER)))
+		return kdef->name;
+	else if (kdef->letter != KIND_NULL_LETTER  && (isFieldEnabled (FIELD_KIND) ||
+			(isFieldEnabled (FIELD_KIND_LONG) &&  kdef->name == NULL)))
+		return letter;
+	return NULL;
+}
+
+static void addFieldMaybe (binaryRecord *r, const tagEntryInfo *const tag, fieldType ftype)
+{
+	if (isFieldEnabled (ftype) && doesFieldHaveValue (ftype, tag))
+		addField (r, getFieldName (ftype), renderValue (tag, ftype, NO_PARSER_FIELD));
+}
+
+static void addExtensionFields (binaryRecord *r, const tagEntryInfo *const tag)
+{
+	char letter [2];
+	const char *kind = getKindString (tag, letter);
+	if (kind)
+		r->kind = internString (kind);
+
+	if (isFieldEnabled (FIELD_LINE_NUMBER) && doesFieldHaveValue (FIELD_LINE_NUMBER, tag))
+		r->line = (uint32_t)tag->lineNumber;
+
+	addFieldMaybe (r, tag, FIELD_LANGUAGE);
+
+	if (isFieldEnabled (FIELD_SCOPE))
+	{
+		const char *k = renderValue (tag, FIELD_SCOPE_KIND_LONG, NO_PARSER_FIELD);
+		const char *v = renderValue (tag, FIELD_SCOPE, NO_PARSER_FIELD);
+
+		if (k && v)
+		{
+			if (isFieldEnabled (FIELD_SCOPE_KEY))
+			{
+				static vString *scope;
+
+				scope = vStringNewOrClearWithAutoRelease (scope);
+				vStringCatS (scope, k);
+				vStringPut (scope, ':');
+				vStringCatS (scope, v);
+				addField (r, getFieldName (FIELD_SCOPE_KEY), vStringValue (scope));
+			}
+			else
+				addField (r, k, v);
+		}
+	}
+
+	addFieldMaybe (r, tag, FIELD_TYPE_REF);
+
+	if (isFieldEnabled (FIELD_FILE_SCOPE) && doesFieldHaveValue (FIELD_FILE_SCOPE, tag))
+		r->flags |= RECORD_FILE_SCOPE;
+
+	for (int k = FIELD_ECTAGS_LOOP_START; k <= FIELD_ECTAGS_LOOP_LAST; k++)
+		addFieldMaybe (r, tag, k);
+	for (int k = FIELD_UCTAGS_LOOP_START; k <= FIELD_BUILTIN_LAST; k++)
+		addFieldMaybe (r, tag, k);
+
+	for (unsigned int i = 0; i < tag->usedParserFields; i++)
+	{
+		const tagField *f = getParserFieldForIndex(tag, i);
+		if (isFieldEnabled (f->ftype))
+			addField (r, getFieldName (f->ftype), renderValue (tag, f->ftype, i));
+	}
+}
+
+static int writeBinaryEntry (tagWriter *writer CTAGS_ATTR_UNUSED,
+							 MIO * mio CTAGS_ATTR_UNUSED, const tagEntryInfo *const tag,
+							 void *clientData CTAGS_ATTR_UNUSED)
+{
+	binaryRecord *r = newRecord ();
+
+	r->name = internString (renderValue (tag, FIELD_NAME, NO_PARSER_FIELD));
+	r->file = internString (renderField (FIELD_INPUT_FILE, tag, NO_PARSER_FIELD));
+	r->address = internAddress (tag);
+	if (tag->lineNumberEntry || Option.locate == EX_COMBINE)
+		r->line = (uint32_t)tag->lineNumber;
+
+	if (includeExtensionFlags ())
+		addExtensionFields (r, tag);
+
+	return sizeof (*r) + r->fieldCount * sizeof (binaryField);
+}
+
+static int writeBinaryPtagEntry (tagWriter *writer CTAGS_ATTR_UNUSED,
+								 MIO * mio CTAGS_ATTR_UNUSED, const ptagDesc *desc,
+								 const char *const fileName,
+								 const char *const pattern,
+								 const char *const parserName,
+								 void *clientData CTAGS_ATTR_UNUSED)
+{
+	static vString *buf;
+	binaryRecord *r = newRecord ();
+
+	r->flags = RECORD_PSEUDO;
+
+	buf = vStringNewOrClearWithAutoRelease (buf);
+	vStringCatS (buf, PSEUDO_TAG_PREFIX);
+	vStringCatS (buf, desc->name);
+	if (parserName)
+	{
+		vStringCatS (buf, PSEUDO_TAG_SEPARATOR);
+		vStringCatS (buf, parserName);
+	}
+	r->name = internString (vStringValue (buf));
+
+	r->file = internString (fileName);
+
+	vStringClear (buf);
+	vStringPut (buf, '/');
+	if (pattern)
+		vStringCatS (buf, pattern);
+	vStringPut (buf, '/');
+	r->address = internString (vStringValue (buf));
+
+	return sizeof (*r);
+}
+
+static void rescanFailedBinaryEntry (tagWriter *writer CTAGS_ATTR_UNUSED,
+									 unsigned long validTagNum,
+									 void *clientData CTAGS_ATTR_UNUSED)
+{
+	if (validTagNum < BinaryTags.recordCount)
+	{
+		BinaryTags.fieldCount = BinaryTags.records [validTagNum].field;
+		BinaryTags.recordCount = validTagNum;
+	}
+}
+
+static void checkBinaryOptions (tagWriter *writer CTAGS_ATTR_UNUSED,
+								bool fieldsWereReset CTAGS_ATTR_UNUSED)
+{
+	if (Option.append)
+		error (FATAL, "append mode is not compatible with binary output");
+	if (Option.filter)
+		error (FATAL, "filter mode is not compatible with binary output");
+}
+
+/*
+ * Sorting records
+ */
+static int compareStrings (uint32_t a, uint32_t b, bool foldcase)
+{
+	const unsigned char *s1 = (const unsigned char *)stringAt (a);
+	const unsigned char *s2 = (const unsigned char *)stringAt (b);
+
+	if (!foldcase)
+		return strcmp ((const char *)s1, (const char *)s2);
+
+	int r;
+	do
+		r = toupper (*s1) - toupper (*s2);
+	while (r == 0 && *s1++ != '\0' && *s2++ != '\0');
+	return r;
+}
+
+static int compareNames (const binaryRecord *a, const binaryRecord *b, bool foldcase)
+{
+	return compareStrings (a->name, b->name, foldcase);
+}
+
+static int compareLineNumbers (uint32_t a, uint32_t b)
+{
+	/* Numbers are compared as text in a text tag file. */
+	char s1 [16], s2 [16];
+
+	snprintf (s1, sizeof (s1), "%u", (unsigned int)a);
+	snprintf (s2, sizeof (s2), "%u", (unsigned int)b);
+	return strcmp (s1, s2);
+}
+
+static int compareRecords (const binaryRecord *a, const binaryRecord *b, bool foldcase)
+{
+	int r;
+
+	/* Pseudo tags come first. */
+	if ((a->flags & RECORD_PSEUDO) != (b->flags & RECORD_PSEUDO))
+		return (a->flags & RECORD_PSEUDO)? -1: 1;
+
+	/* Follow the order of the lines in a text tag file as far as
+	 * possible. */
+	r = compareNames (a, b, foldcase);
+	if (r == 0)
+		r = compareStrings (a->file, b->file, foldcase);
+	if (r == 0)
+		r = compareStrings (a->address, b->address, foldcase);
+	if (r == 0)
+		r = compareStrings (a->kind, b->kind, foldcase);
+	if (r == 0 && a->line != b->line)
+		r = compareLineNumbers (a->line, b->line);
+	for (uint32_t i = 0; r == 0 && i < a->fieldCount && i < b->fieldCount; i++)
+	{
+		const binaryField *fa = BinaryTags.fields + a->field + i;
+		const binaryField *fb = BinaryTags.fields + b->field + i;
+
+		r = compareStrings (fa->key, fb->key, foldcase);
+		if (r == 0)
+			r = compareStrings (fa->value, fb->value, foldcase);
+	}
+	if (r == 0)
+		r = (int)a->fieldCount - (int)b->fieldCount;
+	if (r == 0)
+		r = (a < b)? -1: (a > b)? 1: 0;
+	return r;
+}
+
+static int compareRecordsSorted (const void *a, const void *b)
+{
+	return compareRecords (*(binaryRecord *const *)a, *(binaryRecord *const *)b, false);
+}
+
+static int compareRecordsFoldSorted (const void *a, const void *b)
+{
+	return compareRecords (*(binaryRecord *const *)a, *(binaryRecord *const *)b, true);
+}
+
+static bool isSameRecord (const binaryRecord *a, const binaryRecord *b)
+{
+	if (a->name != b->name || a->file != b->file || a->address != b->address
+		|| a->line != b->line || a->kind != b->kind || a->flags != b->flags
+		|| a->fieldCount != b->fieldCount)
+		return false;
+
+	for (uint32_t i = 0; i < a->fieldCount; i++)
+	{
+		const binaryField *fa = BinaryTags.fields + a->field + i;
+		const binaryField *fb = BinaryTags.fields + b->field + i;
+		if (fa->key != fb->key || fa->value != fb->value)
+			return false;
+	}
+	return true;
+}
+
+/* Drop records identical to another one like "sort -u" does for the
+ * lines of a text tag file. Identical records are in the same run of
+ * the records having the same name, input file, and address. */
+static size_t uniqRecords (binaryRecord **records, size_t count)
+{
+	size_t n = 0;
+	size_t run = 0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (n > 0 && (records [run]->name != records [i]->name
+					  || records [run]->file != records [i]->file
+					  || records [run]->address != records [i]->address))
+			run = n;
+
+		size_t j;
+		for (j = run; j < n; j++)
+			if (isSameRecord (records [j], records [i]))
+				break;
+		if (j == n)
+			records [n++] = records [i];
+	}
+	return n;
+}
+
+static binaryRecord *SortingRecords;
+
+static int compareIndexes (const uint32_t *a, const uint32_t *b, bool foldcase)
+{
+	int r = compareNames (SortingRecords + *a, SortingRecords + *b, foldcase);
+	if (r == 0)
+		r = (*a < *b)? -1: (*a > *b)? 1: 0;
+	return r;
+}
+
+static int compareIndexesSorted (const void *a, const void *b)
+{
+	return compareIndexes (a, b, false);
+}
+
+static int compareIndexesFoldSorted (const void *a, const void *b)
+{
+	return compareIndexes (a, b, true);
+}
+
+/*
+ * Writing the file
+ */
+static void putUint32 (unsigned char *buf, uint32_t v)
+{
+	buf [0] = (unsigned char)(v & 0xff);
+	buf [1] = (unsigned char)((v >> 8) & 0xff);
+	buf [2] = (unsigned char)((v >> 16) & 0xff);
+	buf [3] = (unsigned char)((v >> 24) & 0xff);
+}
+
+static void writeUint32s (MIO *mio, const uint32_t *v, size_t count)
+{
+	unsigned char buf [4 * 64];
+
+	while (count > 0)
+	{
+		size_t n = count < 64? count: 64;
+		for (size_t i = 0; i < n; i++)
+			putUint32 (buf + 4 * i, v [i]);
+		mio_write (mio, buf, 4, n);
+		v += n;
+		count -= n;
+	}
+}
+
+static void writeRecords (MIO *mio, binaryRecord **records, size_t count,
+						  uint32_t *nextField)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		binaryRecord r = *records [i];
+
+		/* Fields are written in the order of records. */
+		r.field = *nextField;
+		*nextField += r.fieldCount;
+		writeUint32s (mio, (uint32_t *)&r, sizeof (r) / sizeof (uint32_t));
+	}
+}
+
+static void writeFields (MIO *mio, binaryRecord **records, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		writeUint32s (mio, (uint32_t *)(BinaryTags.fields + records [i]->field),
+					  records [i]->fieldCount * (sizeof (binaryField) / sizeof (uint32_t)));
+}
+
+static void finalizeBinaryOutput (tagWriter *writer CTAGS_ATTR_UNUSED,
+								  MIO * mio,
+								  void *clientData CTAGS_ATTR_UNUSED)
+{
+	size_t count = BinaryTags.recordCount;
+	binaryRecord **records = xMalloc (count? count: 1, binaryRecord *);
+	size_t ptagCount = 0;
+
+	prepareStringTable ();
+	for (size_t i = 0; i < count; i++)
+	{
+		records [i] = BinaryTags.records + i;
+		if (records [i]->flags & RECORD_PSEUDO)
+			ptagCount++;
+	}
+
+	/* Records are ordered as lines in a text tag file are. Pseudo tags
+	 * are moved to the head even if sorting is not requested. */
+	if (Option.sorted == SO_FOLDSORTED)
+	{
+		qsort (records, count, sizeof (*records), compareRecordsFoldSorted);
+		count = uniqRecords (records, count);
+	}
+	else if (Option.sorted == SO_SORTED)
+	{
+		qsort (records, count, sizeof (*records), compareRecordsSorted);
+		count = uniqRecords (records, count);
+	}
+	else
+	{
+		size_t p = 0;
+		for (size_t i = 0; i < count; i++)
+			if (BinaryTags.records [i].flags & RECORD_PSEUDO)
+				records [p++] = BinaryTags.records + i;
+		for (size_t i = 0; i < count; i++)
+			if (!(BinaryTags.records [i].flags & RECORD_PSEUDO))
+				records [p++] = BinaryTags.records + i;
+	}
+
+	size_t tagCount = count - ptagCount;
+	binaryRecord **tags = records + ptagCount;
+	size_t fieldCount = 0;
+	for (size_t i = 0; i < count; i++)
+		fieldCount += records [i]->fieldCount;
+
+	/* Indexes refer the tag records in the order of writing. */
+	binaryRecord *sorted = xMalloc (tagCount? tagCount: 1, binaryRecord);
+	uint32_t *index = xMalloc (tagCount? tagCount: 1, uint32_t);
+	uint32_t *findex = xMalloc (tagCount? tagCount: 1, uint32_t);
+	for (size_t i = 0; i < tagCount; i++)
+	{
+		sorted [i] = *tags [i];
+		index [i] = findex [i] = (uint32_t)i;
+	}
+	SortingRecords = sorted;
+	qsort (index, tagCount, sizeof (*index), compareIndexesSorted);
+	qsort (findex, tagCount, sizeof (*findex), compareIndexesFoldSorted);
+	SortingRecords = NULL;
+	eFree (sorted);
+
+	uint32_t header [2 + 2 * SECTION_COUNT];
+	uint32_t offset = HEADER_SIZE;
+	uint32_t *section = header + 2;
+
+	header [0] = BINARY_TAGS_VERSION;
+	header [1] = Option.sorted;
+
+	section [2 * SECTION_STRINGS] = offset;
+	section [2 * SECTION_STRINGS + 1] = (uint32_t)BinaryTags.stringsLength;
+	offset += (uint32_t)BinaryTags.stringsLength;
+	offset = (offset + 3) & ~3U;
+
+	section [2 * SECTION_PTAGS] = offset;
+	section [2 * SECTION_PTAGS + 1] = (uint32_t)ptagCount;
+	offset += ptagCount * sizeof (binaryRecord);
+
+	section [2 * SECTION_TAGS] = offset;
+	section [2 * SECTION_TAGS + 1] = (uint32_t)tagCount;
+	offset += tagCount * sizeof (binaryRecord);
+
+	section [2 * SECTION_FIELDS] = offset;
+	section [2 * SECTION_FIELDS + 1] = (uint32_t)fieldCount;
+	offset += fieldCount * sizeof (binaryField);
+
+	section [2 * SECTION_INDEX] = offset;
+	section [2 * SECTION_INDEX + 1] = (uint32_t)tagCount;
+	offset += tagCount * sizeof (uint32_t);
+
+	section [2 * SECTION_FINDEX] = offset;
+	section [2 * SECTION_FINDEX + 1] = (uint32_t)tagCount;
+
+	mio_write (mio, BINARY_TAGS_MAGIC, 1, 8);
+	writeUint32s (mio, header, ARRAY_SIZE (header));
+
+	mio_write (mio, BinaryTags.strings, 1, BinaryTags.stringsLength);
+	for (size_t pad = BinaryTags.stringsLength; pad % 4; pad++)
+		mio_putc (mio, '\0');
+
+	uint32_t nextField = 0;
+	writeRecords (mio, records, ptagCount, &nextField);
+	writeRecords (mio, tags, tagCount, &nextField);
+	writeFields (mio, records, ptagCount);
+	writeFields (mio, tags, tagCount);
+	writeUint32s (mio, index, tagCount);
+	writeUint32s (mio, findex, tagCount);
+
+	eFree (findex);
+	eFree (index);
+	eFree (records);
+
+	if (BinaryTags.stringTable)
+		hashTableDelete (BinaryTags.stringTable);
+	if (BinaryTags.strings)
+		eFree (BinaryTags.strings);
+	if (BinaryTags.records)
+		eFree (BinaryTags.records);
+	if (BinaryTags.fields)
+		eFree (BinaryTags.fields);
+	memset (&BinaryTags, 0, sizeof (BinaryTags));
+}
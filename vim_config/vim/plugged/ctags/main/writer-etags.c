@@ -33,6 +33,9 @@ static void *beginEtagsFile (tagWriter *writer, MIO * mio,
 							 void *clientData CTAGS_ATTR_UNUSED);
 static bool  endEtagsFile   (tagWriter *writer, MIO * mio, const char* filename,
 							 void *clientData CTAGS_ATTR_UNUSED);
+static void finalizeEtags (tagWriter *writer, MIO *mio,
+						   void *clientData CTAGS_ATTR_UNUSED);
+static bool canPrintEtagsExtensionFields (void);
 
 tagWriter etagsWriter = {
 	.writeEntry = writeEtagsEntry,
@@ -41,58 +44,57 @@ tagWriter etagsWriter = {
 	.postWriteEntry = endEtagsFile,
 	.rescanFailedEntry = NULL,
 	.treatFieldAsFixed = NULL,
+	.canPrintExtensionFields = canPrintEtagsExtensionFields,
+	.finalizeOutput = finalizeEtags,
 	.defaultFileName = ETAGS_FILE,
 };
 
+/* The section of an input file starts with the byte count of its
+ * entries, so the entries are rendered into SECTION first and copied
+ * to the tag file in one write when the input file is done. */
 struct sEtags {
-	char *name;
-	MIO *mio;
-	size_t byteCount;
+	vString *section;
 	vString *vLine;
 };
 
-
+static struct sEtags Etags;
 
 static void *beginEtagsFile (tagWriter *writer CTAGS_ATTR_UNUSED, MIO *mio CTAGS_ATTR_UNUSED,
 							 void *clientData CTAGS_ATTR_UNUSED)
 {
-	static struct sEtags etags = { NULL, NULL, 0, NULL };
-
-	etags.mio = tempFile ("w+b", &etags.name);
-	etags.byteCount = 0;
-	etags.vLine = vStringNew ();
-	return &etags;
+	if (Etags.section == NULL)
+	{
+		Etags.section = vStringNew ();
+		Etags.vLine = vStringNew ();
+	}
+	vStringClear (Etags.section);
+	return &Etags;
 }
 
 static bool endEtagsFile (tagWriter *writer,
 						  MIO *mainfp, const char *filename,
 						  void *clientData CTAGS_ATTR_UNUSED)
 {
-	const char *line;
 	struct sEtags *etags = writer->private;
 
-	mio_printf (mainfp, "\f\n%s,%ld\n", filename, (long) etags->byteCount);
+	mio_printf (mainfp, "\f\n%s,%ld\n", filename, (long) vStringLength (etags->section));
 	setNumTagsAdded (numTagsAdded () + 1);
+	mio_write (mainfp, vStringValue (etags->section), 1, vStringLength (etags->section));
 	abort_if_ferror (mainfp);
 
-	if (etags->mio != NULL)
-	{
-		mio_rewind (etags->mio);
-
-		while ((line = readLineRaw (etags->vLine, etags->mio)) != NULL)
-			mio_puts (mainfp, line);
-
-		vStringDelete (etags->vLine);
-		mio_unref (etags->mio);
-		remove (etags->name);
-		eFree (etags->name);
-		etags->vLine = NULL;
-		etags->mio = NULL;
-		etags->name = NULL;
-	}
+	vStringClear (etags->section);
 	return false;
 }
 
+static void finalizeEtags (tagWriter *writer CTAGS_ATTR_UNUSED, MIO *mio CTAGS_ATTR_UNUSED,
+						   void *clientData CTAGS_ATTR_UNUSED)
+{
+	vStringDelete (Etags.section);
+	vStringDelete (Etags.vLine);
+	Etags.section = NULL;
+	Etags.vLine = NULL;
+}
+
 static const char* ada_suffix (const tagEntryInfo *const tag, const char *const line)
 {
 	kindDefinition *kdef = getLanguageKind(tag->langType, tag->kindIndex);
@@ -144,20 +146,26 @@ static const char* ada_suffix (const tagEntryInfo *const tag, const char *const
 }
 
 static int writeEtagsEntry (tagWriter *writer,
-							MIO * mio, const tagEntryInfo *const tag,
+							MIO * mio CTAGS_ATTR_UNUSED, const tagEntryInfo *const tag,
 							void *clientData CTAGS_ATTR_UNUSED)
 {
-	langType adaLangType = getNamedLanguage ("Ada", 0);
+	static langType adaLangType = LANG_IGNORE;
+	if (adaLangType == LANG_IGNORE)
+		adaLangType = getNamedLanguage ("Ada", 0);
 	Assert (adaLangType != LANG_IGNORE);
 
-	int length;
 	struct sEtags *etags = writer->private;
-
-	mio = etags->mio;
+	vString *section = etags->section;
+	size_t start = vStringLength (section);
+	char numbers [64];
 
 	if (tag->isFileEntry)
-		length = mio_printf (mio, "\177%s\001%lu,0\n",
-				tag->name, tag->lineNumber);
+	{
+		vStringPut (section, '\177');
+		vStringCatS (section, tag->name);
+		snprintf (numbers, sizeof (numbers), "\001%lu,0\n", tag->lineNumber);
+		vStringCatS (section, numbers);
+	}
 	else
 	{
 		size_t len;
@@ -189,14 +197,20 @@ static int writeEtagsEntry (tagWriter *writer,
 			line [truncationLength] = '\0';
 		}
 
-		length = mio_printf (mio, "%s\177%s%s\001%lu,%ld\n", line,
-							 tag->name,
-							 (tag->langType == adaLangType)
-							 ? ada_suffix (tag, line)
-							 : "",
-							 tag->lineNumber, seekValue);
+		vStringCatS (section, line);
+		vStringPut (section, '\177');
+		vStringCatS (section, tag->name);
+		if (tag->langType == adaLangType)
+			vStringCatS (section, ada_suffix (tag, line));
+		snprintf (numbers, sizeof (numbers), "\001%lu,%ld\n",
+				  tag->lineNumber, seekValue);
+		vStringCatS (section, numbers);
 	}
-	etags->byteCount += length;
 
-	return length;
+	return vStringLength (section) - start;
+}
+
+static bool canPrintEtagsExtensionFields (void)
+{
+	return false;
 }
@@ -17,18 +17,13 @@
 #include "read.h"
 #include "routines.h"
 #include "ptag_p.h"
+#include "vstring.h"
 #include "writer_p.h"
 
 
+#include <stdio.h>
 #include <string.h>
 
-#ifdef HAVE_JANSSON
-#include <jansson.h>
-
-#ifndef json_boolean /* compat with jansson < 2.4 */
-#define json_boolean(val)      ((val) ? json_true() : json_false())
-#endif
-
 
 static int writeJsonEntry  (tagWriter *writer CTAGS_ATTR_UNUSED,
 				MIO * mio, const tagEntryInfo *const tag,
@@ -52,6 +47,137 @@ tagWriter jsonWriter = {
 	.defaultFileName = NULL,
 };
 
+/*
+ * A JSON line is rendered directly into a scratch buffer reused across
+ * tags, and written to the output with one call. Nothing is allocated per
+ * tag once the buffer has grown to the size of the longest line.
+ *
+ * The output is compatible with what json_dumps() of libjansson made
+ * with JSON_PRESERVE_ORDER: members are separated with ", ", a key and its
+ * value with ": ", and a member having a string value that is not valid
+ * UTF-8 is dropped.
+ */
+
+static void catJsonStringMaybe (vString *buf, const char *str, bool *valid)
+{
+	const unsigned char *s = (const unsigned char *)str;
+	const unsigned char *run = s;
+
+	vStringPut (buf, '"');
+	while (*s)
+	{
+		unsigned char c = *s;
+		const char *esc = NULL;
+
+		if (c >= 0x20 && c < 0x80 && c != '"' && c != '\\')
+		{
+			s++;
+			continue;
+		}
+
+		vStringNCatSUnsafe (buf, (const char *)run, s - run);
+
+		if (c >= 0x80)
+		{
+			unsigned int cp;
+			int n;
+
+			if (c < 0xC2)
+				goto invalid;
+			else if (c < 0xE0)
+				n = 1, cp = c & 0x1F;
+			else if (c < 0xF0)
+				n = 2, cp = c & 0x0F;
+			else if (c < 0xF5)
+				n = 3, cp = c & 0x07;
+			else
+				goto invalid;
+
+			for (int i = 1; i <= n; i++)
+			{
+				if ((s[i] & 0xC0) != 0x80)
+					goto invalid;
+				cp = (cp << 6) | (s[i] & 0x3F);
+			}
+			if ((n == 2 && cp < 0x800)
+				|| (n == 3 && cp < 0x10000)
+				|| (cp >= 0xD800 && cp <= 0xDFFF)
+				|| cp > 0x10FFFF)
+				goto invalid;
+
+			vStringNCatSUnsafe (buf, (const char *)s, n + 1);
+			s += n + 1;
+			run = s;
+			continue;
+		}
+
+		switch (c)
+		{
+		case '"':  esc = "\\\""; break;
+		case '\\': esc = "\\\\"; break;
+		case '\b': esc = "\\b";  break;
+		case '\f': esc = "\\f";  break;
+		case '\n': esc = "\\n";  break;
+		case '\r': esc = "\\r";  break;
+		case '\t': esc = "\\t";  break;
+		}
+
+		if (esc)
+			vStringCatS (buf, esc);
+		else
+		{
+			char seq [7];
+			snprintf (seq, sizeof (seq), "\\u%04X", (unsigned int)c);
+			vStringCatS (buf, seq);
+		}
+		s++;
+		run = s;
+	}
+	vStringNCatSUnsafe (buf, (const char *)run, s - run);
+	vStringPut (buf, '"');
+	*valid = true;
+	return;
+
+ invalid:
+	*valid = false;
+}
+
+static void beginJsonMember (vString *buf, const char *key)
+{
+	bool valid;
+
+	vStringCatS (buf, ", ");
+	catJsonStringMaybe (buf, key, &valid);
+	vStringCatS (buf, ": ");
+}
+
+static bool addJsonString (vString *buf, const char *key, const char *str)
+{
+	size_t len = vStringLength (buf);
+	bool valid;
+
+	beginJsonMember (buf, key);
+	catJsonStringMaybe (buf, str, &valid);
+	if (!valid)
+		vStringTruncate (buf, len);
+	return valid;
+}
+
+static void addJsonInteger (vString *buf, const char *key, long long n)
+{
+	char tmp [32];
+
+	beginJsonMember (buf, key);
+	snprintf (tmp, sizeof (tmp), "%lld", n);
+	vStringCatS (buf, tmp);
+}
+
+static void addJsonBoolean (vString *buf, const char *key, bool b)
+{
+	beginJsonMember (buf, key);
+	vStringCatS (buf, b? "true": "false");
+}
+
 static const char* escapeFieldValueRaw (const tagEntryInfo * tag, fieldType ftype, int fieldIndex)
 {
 	const char *v;
@@ -63,7 +189,8 @@ static const char* escapeFieldValueRaw (const tagEntryInfo * tag, fieldType ftyp
 	return v;
 }
 
-static json_t* escapeFieldValue (const tagEntryInfo * tag, fieldType ftype, bool returnEmptyStringAsNoValue)
+static void addFieldValue (vString *buf, const char *key,
+						   const tagEntryInfo * tag, fieldType ftype, bool returnEmptyStringAsNoValue)
 {
 	const char *str = escapeFieldValueRaw (tag, ftype, NO_PARSER_FIELD);
 
@@ -73,35 +200,31 @@ static json_t* escapeFieldValue (const tagEntryInfo * tag, fieldType ftype, bool
 		if (dt & FIELDTYPE_STRING)
 		{
 			if (dt & FIELDTYPE_BOOL && str[0] == '\0')
-				return json_false();
+				addJsonBoolean (buf, key, false);
 			else
-				return json_string (str);
+				addJsonString (buf, key, str);
 		}
 		else if (dt & FIELDTYPE_INTEGER)
 		{
 			long tmp;
 
 			if (strToLong (str, 10, &tmp))
-				return json_integer (tmp);
-			else
-				return NULL;
+				addJsonInteger (buf, key, tmp);
 		}
 		else if (dt & FIELDTYPE_BOOL)
 		{
 			/* TODO: This must be fixed when new boolean field is added.
 			   Currently only `file:' field use this. */
-			return json_boolean (strcmp ("-", str)); /* "-" -> false */
+			addJsonBoolean (buf, key, strcmp ("-", str)); /* "-" -> false */
 		}
-		AssertNotReached ();
-		return NULL;
+		else
+			AssertNotReached ();
 	}
 	else if (returnEmptyStringAsNoValue)
-		return json_false();
-	else
-		return NULL;
+		addJsonBoolean (buf, key, false);
 }
 
-static void renderExtensionFieldMaybe (int xftype, const tagEntryInfo *const tag, json_t *response)
+static void renderExtensionFieldMaybe (vString *buf, int xftype, const tagEntryInfo *const tag)
 {
 	const char *fname = getFieldName (xftype);
 
@@ -110,21 +233,56 @@ static void renderExtensionFieldMaybe (int xftype, const tagEntryInfo *const tag
 		switch (xftype)
 		{
 		case FIELD_LINE_NUMBER:
-			json_object_set_new (response, fname,
-					     json_integer (tag->lineNumber));
+			addJsonInteger (buf, fname, tag->lineNumber);
 			break;
 		case FIELD_FILE_SCOPE:
-			json_object_set_new (response, fname,
-					     json_boolean(1));
+			addJsonBoolean (buf, fname, true);
 			break;
 		default:
-			json_object_set_new (response, fname,
-					     escapeFieldValue (tag, xftype, false));
+			addFieldValue (buf, fname, tag, xftype, false);
 		}
 	}
 }
 
-static void addParserFields (json_t *response, const tagEntryInfo *const tag)
+static bool addParserField (vString *buf, const char *fname,
+							const tagEntryInfo *const tag, unsigned int index)
+{
+	fieldType ftype = getParserFieldForIndex(tag, index)->ftype;
+	unsigned int dt = getFieldDataType (ftype);
+
+	if (dt & FIELDTYPE_STRING)
+	{
+		const char *str = escapeFieldValueRaw (tag, ftype, index);
+		if (dt & FIELDTYPE_BOOL && str[0] == '\0')
+			addJsonBoolean (buf, fname, false);
+		else
+			return addJsonString (buf, fname, str);
+	}
+	else if (dt & FIELDTYPE_INTEGER)
+	{
+		/* NOT IMPLEMENTED YET */
+		AssertNotReached ();
+		return false;
+	}
+	else if (dt & FIELDTYPE_BOOL)
+		addJsonBoolean (buf, fname, true);
+	else
+	{
+		AssertNotReached ();
+		return false;
+	}
+	return true;
+}
+
+static bool isParserFieldNamed (const tagEntryInfo *const tag, unsigned int index,
+								const char *fname)
+{
+	fieldType ftype = getParserFieldForIndex(tag, index)->ftype;
+
+	return isFieldEnabled (ftype) && strcmp (getFieldName (ftype), fname) == 0;
+}
+
+static void addParserFields (vString *buf, const tagEntryInfo *const tag)
 {
 	unsigned int i;
 
@@ -135,35 +293,34 @@ static void addParserFields (json_t *response, const tagEntryInfo *const tag)
 		if (! isFieldEnabled (ftype))
 			continue;
 
-		unsigned int dt = getFieldDataType (ftype);
-		json_t *o;
-		if (dt & FIELDTYPE_STRING)
-		{
-			const char *str = escapeFieldValueRaw (tag, ftype, i);
-			if (dt & FIELDTYPE_BOOL && str[0] == '\0')
-				o = json_false ();
-			else
-				o = json_string (str);
-		}
-		else if (dt & FIELDTYPE_INTEGER)
+		/* A parser can attach a field to a tag more than once.
+		 * A key appears only once in a JSON object; the value of the last
+		 * field is printed at the position of the first one. */
+		const char *fname = getFieldName (ftype);
+		unsigned int j;
+		bool printed = false;
+
+		for (j = 0; j < i; j++)
 		{
-			/* NOT IMPLEMENTED YET */
-			AssertNotReached ();
-			o = json_null ();
+			if (isParserFieldNamed (tag, j, fname))
+			{
+				printed = true;
+				break;
+			}
 		}
-		else if (dt & FIELDTYPE_BOOL)
-			o = json_true ();
-		else
+		if (printed)
+			continue;
+
+		for (j = tag->usedParserFields; j > i; j--)
 		{
-			AssertNotReached ();
-			o = json_null ();
+			if (isParserFieldNamed (tag, j - 1, fname)
+				&& addParserField (buf, fname, tag, j - 1))
+				break;
 		}
-
-		json_object_set_new (response, getFieldName (ftype), o);
 	}
 }
 
-static void addExtensionFields (json_t *response, const tagEntryInfo *const tag)
+static void addExtensionFields (vString *buf, const tagEntryInfo *const tag)
 {
 	int k;
 
@@ -184,49 +341,42 @@ static void addExtensionFields (json_t *response, const tagEntryInfo *const tag)
 	}
 
 	for (k = FIELD_JSON_LOOP_START; k <= FIELD_BUILTIN_LAST; k++)
-		renderExtensionFieldMaybe (k, tag, response);
+		renderExtensionFieldMaybe (buf, k, tag);
 }
 
 static int writeJsonEntry (tagWriter *writer CTAGS_ATTR_UNUSED,
 			       MIO * mio, const tagEntryInfo *const tag,
 				   void *clientData CTAGS_ATTR_UNUSED)
 {
-	int length = 0;
-	json_t *response = json_pack ("{ss}", "_type", "tag");
+	static vString *buf;
+	size_t typeOnlyLength;
+
+	buf = vStringNewOrClearWithAutoRelease (buf);
+	vStringCatS (buf, "{\"_type\": \"tag\"");
+	typeOnlyLength = vStringLength (buf);
 
 	if (isFieldEnabled (FIELD_NAME))
 	{
-		json_t *name = json_string (tag->name);
-		if (name == NULL)
-			goto out;
-		json_object_set_new (response, "name", name);
+		if (!addJsonString (buf, "name", tag->name))
+			return 0;
 	}
 	if (isFieldEnabled (FIELD_INPUT_FILE))
-		json_object_set_new (response, "path", json_string (tag->sourceFileName));
+		addJsonString (buf, "path", tag->sourceFileName);
 	if (isFieldEnabled (FIELD_PATTERN))
-	{
-		json_t *pat = escapeFieldValue(tag, FIELD_PATTERN, true);
-		json_object_set_new (response, "pattern", pat);
-	}
+		addFieldValue (buf, "pattern", tag, FIELD_PATTERN, true);
 
 	if (includeExtensionFlags ())
 	{
-		addExtensionFields (response, tag);
-		addParserFields (response, tag);
+		addExtensionFields (buf, tag);
+		addParserFields (buf, tag);
 	}
 
-	/* Print nothing if RESPONSE has only "_type" field. */
-	if (json_object_size (response) == 1)
-		goto out;
-
-	char *buf = json_dumps (response, JSON_PRESERVE_ORDER);
-	length = mio_printf (mio, "%s\n", buf);
+	/* Print nothing if BUF has only "_type" field. */
+	if (vStringLength (buf) == typeOnlyLength)
+		return 0;
 
-	free (buf);
- out:
-	json_decref (response);
-
-	return length;
+	vStringCatS (buf, "}\n");
+	return mio_write (mio, vStringValue (buf), 1, vStringLength (buf));
 }
 
 static int writeJsonPtagEntry (tagWriter *writer CTAGS_ATTR_UNUSED,
@@ -237,32 +387,24 @@ static int writeJsonPtagEntry (tagWriter *writer CTAGS_ATTR_UNUSED,
 				   void *clientData CTAGS_ATTR_UNUSED)
 {
 #define OPT(X) ((X)?(X):"")
-	json_t *response;
-
-	if (parserName)
-	{
-		response = json_pack ("{ss ss ss ss ss}",
-				      "_type", "ptag",
-				      "name", desc->name,
-				      "parserName", parserName,
-				      "path", OPT(fileName),
-				      "pattern", OPT(pattern));
-	}
-	else
-	{
-		response = json_pack ("{ss ss ss ss}",
-				      "_type", "ptag",
-				      "name", desc->name,
-				      "path", OPT(fileName),
-				      "pattern", OPT(pattern));
-	}
-
-	char *buf = json_dumps (response, JSON_PRESERVE_ORDER);
-	int length = mio_printf (mio, "%s\n", buf);
-	free (buf);
-	json_decref (response);
-
-	return length;
+	static vString *buf;
+	bool valid;
+
+	buf = vStringNewOrClearWithAutoRelease (buf);
+	vStringCatS (buf, "{\"_type\": \"ptag\"");
+
+	valid = addJsonString (buf, "name", desc->name);
+	if (valid && parserName)
+		valid = addJsonString (buf, "parserName", parserName);
+	if (valid)
+		valid = addJsonString (buf, "path", OPT(fileName));
+	if (valid)
+		valid = addJsonString (buf, "pattern", OPT(pattern));
+	if (!valid)
+		return 0;
+
+	vStringCatS (buf, "}\n");
+	return mio_write (mio, vStringValue (buf), 1, vStringLength (buf));
 #undef OPT
 }
 
@@ -274,21 +416,3 @@ extern bool ptagMakeJsonOutputVersion (ptagDesc *desc, langType language CTAGS_A
 			       "in development",
 			       NULL);
 }
-
-#else /* HAVE_JANSSON */
-
-tagWriter jsonWriter = {
-	.writeEntry = NULL,
-	.writePtagEntry = NULL,
-	.preWriteEntry = NULL,
-	.postWriteEntry = NULL,
-	.defaultFileName = "-",
-};
-
-extern bool ptagMakeJsonOutputVersion (ptagDesc *desc, langType language CTAGS_ATTR_UNUSED,
-									   const void *data CTAGS_ATTR_UNUSED)
-{
-	return false;
-}
-
-#endif
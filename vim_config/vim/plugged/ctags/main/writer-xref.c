@@ -28,6 +28,7 @@ static int writeXrefPtagEntry (tagWriter *writer, MIO * mio, const ptagDesc *des
 							   const char *const pattern,
 							   const char *const parserName,
 							   void *clientData);
+static bool canPrintXrefExtensionFields (void);
 
 tagWriter xrefWriter = {
 	.writeEntry = writeXrefEntry,
@@ -37,6 +38,7 @@ tagWriter xrefWriter = {
 	.postWriteEntry = NULL,
 	.rescanFailedEntry = NULL,
 	.treatFieldAsFixed = NULL,
+	.canPrintExtensionFields = canPrintXrefExtensionFields,
 	.defaultFileName = NULL,
 };
 
@@ -104,3 +106,9 @@ static int writeXrefEntry (tagWriter *writer CTAGS_ATTR_UNUSED,
 
 	return length;
 }
+
+/* --_xformat can refer to any field regardless of --format. */
+static bool canPrintXrefExtensionFields (void)
+{
+	return true;
+}
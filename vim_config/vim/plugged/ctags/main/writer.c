@@ -19,6 +19,7 @@ extern tagWriter eCtagsWriter;
 extern tagWriter etagsWriter;
 extern tagWriter xrefWriter;
 extern tagWriter jsonWriter;
+extern tagWriter binaryWriter;
 
 static tagWriter *writerTable [WRITER_COUNT] = {
 	[WRITER_U_CTAGS] = &uCtagsWriter,
@@ -26,6 +27,7 @@ static tagWriter *writerTable [WRITER_COUNT] = {
 	[WRITER_ETAGS] = &etagsWriter,
 	[WRITER_XREF]  = &xrefWriter,
 	[WRITER_JSON]  = &jsonWriter,
+	[WRITER_BINARY] = &binaryWriter,
 	[WRITER_CUSTOM] = NULL,
 };
 
@@ -91,6 +93,17 @@ extern void writerRescanFailed (unsigned long validTagNum)
 		writer->rescanFailedEntry(writer, validTagNum, writer->clientData);
 }
 
+extern void writerFinalizeOutput (MIO *mio)
+{
+	if (writer->finalizeOutput)
+		writer->finalizeOutput (writer, mio, writer->clientData);
+}
+
+extern bool writerProducesBinaryOutput (void)
+{
+	return writer->binaryOutput;
+}
+
 extern bool ptagMakeCtagsOutputMode (ptagDesc *desc, langType langType CTAGS_ATTR_UNUSED,
 									 const void *data CTAGS_ATTR_UNUSED)
 {
@@ -124,6 +137,13 @@ extern bool writerDoesTreatFieldAsFixed (int fieldType)
 	return false;
 }
 
+extern bool writerCanPrintExtensionFields (void)
+{
+	if (writer->canPrintExtensionFields)
+		return writer->canPrintExtensionFields ();
+	return includeExtensionFlags ();
+}
+
 #ifdef WIN32
 extern enum filenameSepOp getFilenameSeparator (enum filenameSepOp currentSetting)
 {
@@ -14,6 +14,9 @@
 #include "options_p.h"
 #include "types.h"
 
+/* The first 8 bytes of a tag file in the binary format. */
+#define BINARY_TAGS_MAGIC "!_TAGBIN"
+
 /* Other than writeEntry can be NULL.
    The value returned from preWriteEntry is passed to writeEntry,
    and postWriteEntry. If a resource is allocated in
@@ -26,6 +29,7 @@ typedef enum eWriterType {
 	WRITER_ETAGS,
 	WRITER_XREF,
 	WRITER_JSON,
+	WRITER_BINARY,
 	WRITER_CUSTOM,
 	WRITER_COUNT,
 } writerType;
@@ -52,8 +56,21 @@ struct sTagWriter {
 								void *clientData);
 	bool (* treatFieldAsFixed) (int fieldType);
 
+	/* Return false if the writer prints no extension field whatever
+	   --fields= says. NULL means it prints them unless --format=1
+	   is given. */
+	bool (* canPrintExtensionFields) (void);
+
 	void (* checkOptions) (tagWriter *writer, bool fieldsWereReset);
 
+	/* Called once before closing the tag file. A writer keeping
+	   tags in memory writes them here. */
+	void (* finalizeOutput) (tagWriter *writer, MIO * mio, void *clientData);
+
+	/* The output is not a sequence of lines. ctags doesn't sort
+	   it, and opens the tag file in binary mode. */
+	bool binaryOutput;
+
 #ifdef WIN32
 	enum filenameSepOp (* overrideFilenameSeparator) (enum filenameSepOp currentSetting);
 #endif	/* WIN32 */
@@ -82,6 +99,8 @@ int writerWritePtag (MIO * mio,
 					 const char *const parserName);
 
 void writerRescanFailed (unsigned long validTagNum);
+extern void writerFinalizeOutput (MIO *mio);
+extern bool writerProducesBinaryOutput (void);
 
 extern const char *outputDefaultFileName (void);
 
@@ -96,6 +115,7 @@ extern bool ptagMakeCtagsOutputExcmd (ptagDesc *desc, langType language CTAGS_AT
 
 extern bool writerCanPrintPtag (void);
 extern bool writerDoesTreatFieldAsFixed (int fieldType);
+extern bool writerCanPrintExtensionFields (void);
 
 extern void writerCheckOptions (bool fieldsWereReset);
 extern bool writerPrintPtagByDefault (void);
@@ -25,6 +25,7 @@ help:
 	@echo "make chop                         - Verify the behavior of parsers for broken input: randomly truncated from tail"
 	@echo "make slap                         - Verify the behavior of parsers for broken input: randomly truncated from head"
 	@echo "make roundtrip                    - Verify the behavior of readtags command"
+	@echo "make bench                        - Measure time, memory and tags/s with synthesized corpora"
 	@echo
 	@echo "Arguments that can be used in testing targets:"
 	@echo
@@ -35,6 +36,9 @@ help:
 	@echo "UNITS=<case>[,<case>]             - Only run tests named Units/[category.r/]/<case>.d in units target"
 	@echo "                                                         Tmain/<case>.d in tmain target"
 	@echo "PMAP=<newlang>/<oldlang>[,...]    - Make <newlang> parser pretend <oldlang> (units target only)"
+	@echo "BENCH=<corpus>[,<corpus>]         - Only measure the selected corpora (bench target only)"
+	@echo "BASELINE=<file>                   - Fail if slower or bigger than the baseline (bench target only)"
+	@echo "SAVE_BASELINE=<file>              - Store the results as a baseline (bench target only)"
 	@echo ""
 	@echo "Input validation target:"
 	@echo ""
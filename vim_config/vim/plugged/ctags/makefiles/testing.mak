@@ -1,15 +1,16 @@
 # -*- makefile -*-
-.PHONY: check units fuzz noise tmain tinst tlib man-test clean-units clean-tlib clean-tmain clean-gcov clean-man-test run-gcov codecheck cppcheck dicts validate-input check-genfile
+.PHONY: check units fuzz noise tmain tinst tlib man-test bench clean-units clean-tlib clean-tmain clean-gcov clean-man-test clean-bench run-gcov codecheck cppcheck dicts validate-input check-genfile
 
-EXTRA_DIST += misc/units misc/units.py misc/man-test.py
+EXTRA_DIST += misc/units misc/units.py misc/man-test.py misc/bench.py
 EXTRA_DIST += misc/tlib misc/mini-geany.expected
 MAN_TEST_TMPDIR = ManTest
+BENCH_WORKDIR = Bench
 
 check: tmain units tlib man-test check-genfile
 
 # We may use CLEANFILES, DISTCLEANFILES, or etc.
 # clean-tlib and clean-gcov are not included
-clean-local: clean-units clean-tmain clean-man-test
+clean-local: clean-units clean-tmain clean-man-test clean-bench
 
 CTAGS_TEST = ./ctags$(EXEEXT)
 READTAGS_TEST = ./readtags$(EXEEXT)
@@ -26,6 +27,9 @@ LANGUAGES=
 CATEGORIES=
 UNITS=
 PMAP=
+BENCH=
+BASELINE=
+SAVE_BASELINE=
 
 SILENT = $(SILENT_@AM_V@)
 SILENT_ = $(SILENT_@AM_DEFAULT_V@)
@@ -290,6 +294,24 @@ man-test: $(CTAGS_TEST)
 clean-man-test:
 	rm -rf $(MAN_TEST_TMPDIR)
 
+#
+# Measuring performance with synthesized corpora
+#
+bench: $(CTAGS_TEST)
+	$(V_RUN) \
+	if test -n "$(BASELINE)"; then		\
+		BASELINE_OPT=--baseline=$(BASELINE);	\
+	fi;					\
+	if test -n "$(SAVE_BASELINE)"; then	\
+		SAVE_BASELINE_OPT=--save-baseline=$(SAVE_BASELINE);	\
+	fi;					\
+	$(PYTHON) $(srcdir)/misc/bench.py --ctags=$(CTAGS_TEST) \
+		--workdir=$(BENCH_WORKDIR) --only=$(BENCH) \
+		$${BASELINE_OPT} $${SAVE_BASELINE_OPT}
+
+clean-bench:
+	rm -rf $(BENCH_WORKDIR)
+
 # check if generated files are committed.
 #   Note: "make -B" cannot be used here, since it reruns automake
 chkgen_verbose = $(chkgen_verbose_@AM_V@)
@@ -0,0 +1,352 @@
+#!/usr/bin/env python3
+
+#
+# bench.py - measure the performance of ctags with synthesized corpora
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+#
+# Python 3.5 or later is required.
+#
+# Each corpus is generated from a fixed random seed, so two runs with
+# the same GENERATOR_VERSION and --scale see byte-identical input.
+# ctags runs with --options=NONE and, when it supports it,
+# --totals=profile; wall time, peak RSS, tags per second and the
+# per-phase timings are recorded.  An older ctags without
+# --totals=profile can still be measured to make a baseline.
+#
+
+import argparse
+import json
+import os
+import random
+import shutil
+import subprocess
+import sys
+import time
+
+GENERATOR_VERSION = 1
+
+CTAGS_OPTIONS = ['--options=NONE', '--fields=+n', '--sort=yes', '-R']
+
+#
+# Corpus generators
+#
+def words(rnd, n, prefix):
+    return ['%s_%s%d' % (prefix, rnd.choice(['get', 'set', 'init', 'free', 'do', 'is']), i)
+            for i in range(n)]
+
+def gen_c(rnd, out, scale):
+    for d in range(8 * scale):
+        ddir = os.path.join(out, 'drivers%d' % d)
+        os.makedirs(ddir)
+        for f in range(40):
+            base = 'mod%d_%d' % (d, f)
+            with open(os.path.join(ddir, base + '.h'), 'w') as h:
+                h.write('#ifndef %s_H\n#define %s_H\n' % (base.upper(), base.upper()))
+                for s in range(6):
+                    h.write('struct %s_s%d {\n' % (base, s))
+                    for m in range(8):
+                        h.write('\tint field%d;\n' % m)
+                    h.write('\tunsigned long flags;\n};\n')
+                    h.write('#define %s_MAX%d %d\n' % (base.upper(), s, rnd.randint(1, 999)))
+                for fn in words(rnd, 12, base):
+                    h.write('extern int %s (struct %s_s0 *p, int n);\n' % (fn, base))
+                h.write('#endif\n')
+            with open(os.path.join(ddir, base + '.c'), 'w') as c:
+                c.write('#include "%s.h"\n\n' % base)
+                c.write('static int %s_table[] = { %s };\n\n'
+                        % (base, ', '.join(str(rnd.randint(0, 99)) for _ in range(32))))
+                for fn in words(rnd, 12, base):
+                    c.write('int %s (struct %s_s0 *p, int n)\n{\n' % (fn, base))
+                    c.write('\tint i, r = 0;\n#ifdef CONFIG_%s\n\tr = -1;\n#else\n' % fn.upper())
+                    c.write('\tfor (i = 0; i < n; i++)\n\t{\n')
+                    c.write('\t\tif (p->field%d > %d)\n\t\t\tr += %s_table[i %% 32];\n'
+                            % (rnd.randint(0, 7), rnd.randint(0, 99), base))
+                    c.write('\t\telse\n\t\t\tr -= p->flags;\n\t}\n#endif\n\treturn r;\n}\n\n')
+
+def gen_cxx(rnd, out, scale):
+    for f in range(120 * scale):
+        with open(os.path.join(out, 'unit%d.cpp' % f), 'w') as o:
+            o.write('#include <vector>\n#include <map>\n\nnamespace lib%d {\n' % f)
+            for k in range(8):
+                o.write('template <typename T, int N = %d>\n' % k)
+                o.write('class Widget%d_%d : public Base<T> {\npublic:\n' % (f, k))
+                o.write('\tWidget%d_%d () : size_(N) {}\n' % (f, k))
+                o.write('\tvirtual ~Widget%d_%d () = default;\n' % (f, k))
+                for m in words(rnd, 8, 'm'):
+                    o.write('\tstd::vector<T> %s (const std::map<int, T> &in) const;\n' % m)
+                o.write('private:\n\tint size_;\n\tstd::vector<T> data_;\n};\n\n')
+                for m in words(rnd, 4, 'm'):
+                    o.write('template <typename T, int N>\n')
+                    o.write('std::vector<T> Widget%d_%d<T, N>::%s (const std::map<int, T> &in) const\n'
+                            % (f, k, m))
+                    o.write('{\n\tstd::vector<T> r;\n\tfor (auto &kv : in)\n')
+                    o.write('\t\tif (kv.first > %d) r.push_back (kv.second);\n' % rnd.randint(0, 9))
+                    o.write('\treturn r;\n}\n\n')
+            o.write('} // namespace lib%d\n' % f)
+
+def gen_js_min(rnd, out, scale):
+    for f in range(4 * scale):
+        parts = []
+        for i in range(3000):
+            n = 'f%d_%d' % (f, i)
+            parts.append('function %s(a,b){var c=a+b*%d;if(c>%d){return c}return %s(b,a)}'
+                         % (n, rnd.randint(1, 9), rnd.randint(0, 99), n))
+            parts.append('var o%d={k%d:function(x){return x*2},v:[%d,%d]};'
+                         % (i, i, rnd.randint(0, 9), rnd.randint(0, 9)))
+        with open(os.path.join(out, 'bundle%d.min.js' % f), 'w') as o:
+            o.write(''.join(parts))
+
+def gen_yaml(rnd, out, scale):
+    for f in range(20 * scale):
+        with open(os.path.join(out, 'site%d.yml' % f), 'w') as o:
+            for p in range(300):
+                o.write('- name: play %d of site %d\n  hosts: group%d\n' % (p, f, rnd.randint(0, 9)))
+                o.write('  vars:\n    port: &port%d %d\n    backup: *port%d\n' % (p, rnd.randint(1, 65535), p))
+                o.write('  tasks:\n')
+                for t in range(4):
+                    o.write('    - name: task %d\n      command: /bin/true %d\n' % (t, rnd.randint(0, 9)))
+
+def gen_xml(rnd, out, scale):
+    for f in range(2 * scale):
+        with open(os.path.join(out, 'drawing%d.svg' % f), 'w') as o:
+            o.write('<?xml version="1.0"?>\n<svg xmlns="http://www.w3.org/2000/svg">\n<defs>\n')
+            for i in range(500):
+                o.write('  <linearGradient id="grad%d"/>\n' % i)
+            o.write('</defs>\n')
+            for i in range(5000):
+                o.write('  <g id="g%d"><path id="p%d" d="M%d,%d L%d,%d"/></g>\n'
+                        % (i, i, rnd.randint(0, 999), rnd.randint(0, 999),
+                           rnd.randint(0, 999), rnd.randint(0, 999)))
+            o.write('</svg>\n')
+        with open(os.path.join(out, 'pom%d.xml' % f), 'w') as o:
+            o.write('<?xml version="1.0"?>\n<project xmlns="http://maven.apache.org/POM/4.0.0">\n')
+            o.write('  <modelVersion>4.0.0</modelVersion>\n  <groupId>org.example</groupId>\n')
+            o.write('  <artifactId>bench%d</artifactId>\n  <version>1.0</version>\n  <dependencies>\n' % f)
+            for i in range(2000):
+                o.write('    <dependency><groupId>g%d</groupId><artifactId>a%d</artifactId>'
+                        '<version>%d.0</version></dependency>\n' % (i, i, rnd.randint(1, 9)))
+            o.write('  </dependencies>\n</project>\n')
+
+def gen_optlib(rnd, out, scale):
+    for f in range(20 * scale):
+        with open(os.path.join(out, 'mod%d.ex' % f), 'w') as o:
+            o.write('defmodule Bench.Mod%d do\n' % f)
+            for i in range(100):
+                o.write('  @doc "function %d"\n  def fun%d(a, b) do\n    a + b * %d\n  end\n\n'
+                        % (i, i, rnd.randint(0, 9)))
+                o.write('  defp helper%d(x), do: x\n  defmacro mac%d(x), do: x\n' % (i, i))
+            o.write('end\n')
+        d = os.path.join(out, 'cmake%d' % f)
+        os.makedirs(d)
+        with open(os.path.join(d, 'CMakeLists.txt'), 'w') as o:
+            o.write('project(bench%d)\n' % f)
+            for i in range(200):
+                o.write('set(VAR_%d "%d")\nfunction(fn_%d arg)\n  message(${arg})\nendfunction()\n'
+                        'add_library(lib%d STATIC src%d.c)\n' % (i, rnd.randint(0, 9), i, i, i))
+
+GENERATORS = [
+    ('c-tree', gen_c),
+    ('cxx', gen_cxx),
+    ('js-min', gen_js_min),
+    ('yaml', gen_yaml),
+    ('xml', gen_xml),
+    ('optlib', gen_optlib),
+]
+
+def prepare_corpus(workdir, name, gen, scale):
+    cdir = os.path.join(workdir, 'corpora', name)
+    stamp = os.path.join(cdir, '.stamp')
+    want = '%d %d\n' % (GENERATOR_VERSION, scale)
+    if os.path.exists(stamp):
+        with open(stamp) as f:
+            if f.read() == want:
+                return cdir
+    if os.path.exists(cdir):
+        shutil.rmtree(cdir)
+    os.makedirs(cdir)
+    gen(random.Random(name), cdir, scale)
+    with open(stamp, 'w') as f:
+        f.write(want)
+    return cdir
+
+#
+# Measurement
+#
+def has_profile(ctags):
+    r = subprocess.run([ctags, '--options=NONE', '--totals=profile', '--version'],
+                       stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    return r.returncode == 0
+
+def count_tags(tags):
+    n = 0
+    with open(tags, 'rb') as f:
+        for line in f:
+            if not line.startswith(b'!_'):
+                n += 1
+    return n
+
+# ru_maxrss of a child covers the memory its parent had when it forked,
+# so the peak RSS of ctags taken with os.wait4 from this process would
+# include the high-water mark of this script.  ctags is forked from a
+# small interpreter instead.  It writes the ru_maxrss and the wall
+# time of ctags to its stdout, leaving its own start-up out of the
+# measurement, and exits with the status of ctags.
+RSS_WRAPPER = '''
+import os, sys, time
+start = time.monotonic()
+pid = os.fork()
+if pid == 0:
+    fd = os.open(os.devnull, os.O_WRONLY)
+    os.dup2(fd, 1)
+    os.execv(sys.argv[1], sys.argv[1:])
+_, status, usage = os.wait4(pid, 0)
+print(usage.ru_maxrss, time.monotonic() - start)
+sys.stdout.flush()
+os._exit(os.WEXITSTATUS(status) if os.WIFEXITED(status) else 128 + os.WTERMSIG(status))
+'''
+
+def run_once(ctags, profiling, corpus, tags):
+    cmd = [ctags] + CTAGS_OPTIONS + (['--totals=profile'] if profiling else []) + ['-o', tags, corpus]
+    measure_rss = hasattr(os, 'wait4') and hasattr(os, 'fork')
+    start = time.monotonic()
+    if measure_rss:
+        p = subprocess.Popen([sys.executable, '-S', '-E', '-c', RSS_WRAPPER] + cmd,
+                             stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                             universal_newlines=True)
+    else:
+        p = subprocess.Popen(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE,
+                             universal_newlines=True)
+    out, err = p.communicate()
+    wall = time.monotonic() - start
+    rss = None
+    if measure_rss and out.strip():
+        rss, wall = int(out.split()[0]), float(out.split()[1])
+    if p.returncode != 0:
+        sys.stderr.write(err)
+        raise RuntimeError('%s exited with %d' % (' '.join(cmd), p.returncode))
+    if profiling:
+        profile = json.loads(err[err.index('{'):])
+    else:
+        profile = {'files': None, 'bytes': None, 'phases': None}
+    # Counted in the output rather than taken from the profile so that
+    # results of ctags with and without --totals=profile are comparable.
+    ntags = count_tags(tags)
+    return {
+        'wall': round(wall, 4),
+        'rss_kb': rss,
+        'files': profile['files'],
+        'bytes': profile['bytes'],
+        'tags': ntags,
+        'tags_per_sec': round(ntags / wall) if wall > 0 else None,
+        'phases': profile['phases'],
+    }
+
+def run_bench(ctags, profiling, name, corpus, workdir, repeat):
+    tags = os.path.join(workdir, 'tags.' + name)
+    best = None
+    for _ in range(repeat):
+        r = run_once(ctags, profiling, corpus, tags)
+        if best is None or r['wall'] < best['wall']:
+            best = r
+    os.remove(tags)
+    return best
+
+#
+# Reporting
+#
+def print_result(name, r):
+    rss = '%dK' % r['rss_kb'] if r['rss_kb'] is not None else '-'
+    files = '%d' % r['files'] if r['files'] is not None else '-'
+    print('%-10s %8.3fs %10s %7s files %9d tags %10d tags/s'
+          % (name, r['wall'], rss, files, r['tags'], r['tags_per_sec'] or 0))
+
+def compare(results, baseline, time_threshold, rss_threshold):
+    regressions = 0
+    for name, r in results.items():
+        b = baseline.get(name)
+        if b is None:
+            print('%-10s no baseline' % name)
+            continue
+        verdicts = []
+        ratio = r['wall'] / b['wall'] if b['wall'] else 1.0
+        verdicts.append('time %+.1f%%' % ((ratio - 1) * 100))
+        bad = ratio > 1 + time_threshold / 100.0
+        if r['rss_kb'] and b.get('rss_kb'):
+            rss_ratio = r['rss_kb'] / b['rss_kb']
+            verdicts.append('rss %+.1f%%' % ((rss_ratio - 1) * 100))
+            bad = bad or rss_ratio > 1 + rss_threshold / 100.0
+        if r['tags'] != b['tags']:
+            verdicts.append('tags %d -> %d' % (b['tags'], r['tags']))
+        print('%-10s %-9s %s' % (name, 'REGRESSED' if bad else 'ok', ', '.join(verdicts)))
+        if bad:
+            regressions += 1
+    return regressions
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark ctags with synthesized corpora')
+    parser.add_argument('--ctags', default='./ctags', help='ctags executable to measure')
+    parser.add_argument('--workdir', default='Bench', help='where corpora and results are stored')
+    parser.add_argument('--repeat', type=int, default=5, help='runs per corpus; the fastest is kept')
+    parser.add_argument('--scale', type=int, default=1, help='multiplier for the corpus sizes')
+    parser.add_argument('--only', default='', help='comma separated list of corpora to run')
+    parser.add_argument('--corpus', action='append', default=[], metavar='NAME=DIR',
+                        help='also measure an existing source tree (e.g. a pinned checkout)')
+    parser.add_argument('--baseline', help='compare against results saved with --save-baseline')
+    parser.add_argument('--save-baseline', help='store the results as a baseline')
+    parser.add_argument('--time-threshold', type=float, default=10.0,
+                        help='allowed wall time growth in percent (default: 10)')
+    parser.add_argument('--rss-threshold', type=float, default=10.0,
+                        help='allowed peak RSS growth in percent (default: 10)')
+    args = parser.parse_args()
+
+    only = [n for n in args.only.split(',') if n]
+    os.makedirs(args.workdir, exist_ok=True)
+
+    corpora = []
+    for name, gen in GENERATORS:
+        if only and name not in only:
+            continue
+        corpora.append((name, prepare_corpus(args.workdir, name, gen, args.scale)))
+    for spec in args.corpus:
+        name, _, d = spec.partition('=')
+        if not d or not os.path.isdir(d):
+            parser.error('--corpus expects NAME=DIR: %s' % spec)
+        if not only or name in only:
+            corpora.append((name, d))
+
+    profiling = has_profile(args.ctags)
+    results = {}
+    for name, corpus in corpora:
+        results[name] = run_bench(args.ctags, profiling, name, corpus, args.workdir, args.repeat)
+        print_result(name, results[name])
+
+    with open(os.path.join(args.workdir, 'results.json'), 'w') as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+    if args.save_baseline:
+        with open(args.save_baseline, 'w') as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        print('')
+        if compare(results, baseline, args.time_threshold, args.rss_threshold):
+            return 1
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -3308,22 +3308,26 @@ static bool_t generate(context_t *ctx) {
             "} pcc_lr_memo_t;\n"
             "\n"
             "typedef struct pcc_lr_memo_map_tag {\n"
-            "    pcc_lr_memo_t *buf;\n"
+            "    pcc_lr_memo_t *buf; /* open addressing hash table keyed by rule; max is a power of 2 */\n"
             "    size_t max;\n"
             "    size_t len;\n"
             "} pcc_lr_memo_map_t;\n"
             "\n"
-            "typedef struct pcc_lr_table_entry_tag {\n"
+            "typedef struct pcc_lr_table_entry_tag pcc_lr_table_entry_t;\n"
+            "\n"
+            "struct pcc_lr_table_entry_tag {\n"
             "    pcc_lr_head_t *head; /* just a reference */\n"
             "    pcc_lr_memo_map_t memos;\n"
             "    pcc_lr_answer_t *hold_a;\n"
             "    pcc_lr_head_t *hold_h;\n"
-            "} pcc_lr_table_entry_t;\n"
+            "    pcc_lr_table_entry_t *next; /* link in the free list */\n"
+            "};\n"
             "\n"
             "typedef struct pcc_lr_table_tag {\n"
             "    pcc_lr_table_entry_t **buf;\n"
             "    size_t max;\n"
             "    size_t len;\n"
+            "    pcc_lr_table_entry_t *free; /* entries released by commits, kept for reuse */\n"
             "} pcc_lr_table_t;\n"
             "\n"
             "struct pcc_lr_entry_tag {\n"
@@ -3794,51 +3798,73 @@ static bool_t generate(context_t *ctx) {
         );
         fputs_e(
             "static void pcc_lr_memo_map__init(pcc_auxil_t auxil, pcc_lr_memo_map_t *map, size_t max) {\n"
+            "    size_t i;\n"
+            "    size_t m = 1;\n"
+            "    while (m < max) m <<= 1;\n"
             "    map->len = 0;\n"
-            "    map->max = max;\n"
+            "    map->max = m;\n"
             "    map->buf = (pcc_lr_memo_t *)PCC_MALLOC(auxil, sizeof(pcc_lr_memo_t) * map->max);\n"
+            "    for (i = 0; i < map->max; i++) map->buf[i].rule = NULL;\n"
             "}\n"
             "\n"
-            "static size_t pcc_lr_memo_map__index(pcc_auxil_t auxil, pcc_lr_memo_map_t *map, pcc_rule_t rule) {\n"
+            "static size_t pcc_lr_memo_map__hash(pcc_rule_t rule) {\n"
+            "    const unsigned char *const p = (const unsigned char *)&rule;\n"
+            "    size_t h = 0;\n"
             "    size_t i;\n"
-            "    for (i = 0; i < map->len; i++) {\n"
-            "        if (map->buf[i].rule == rule) return i;\n"
-            "    }\n"
-            "    return VOID_VALUE;\n"
+            "    for (i = 0; i < sizeof(rule); i++) h = h * 31 + p[i];\n"
+            "    return h ^ (h >> 7);\n"
+            "}\n"
+            "\n"
+            "/* Returns the slot of the rule, or the empty slot where it would be put. */\n"
+            "static size_t pcc_lr_memo_map__index(pcc_auxil_t auxil, pcc_lr_memo_map_t *map, pcc_rule_t rule) {\n"
+            "    const size_t mask = map->max - 1;\n"
+            "    size_t i = pcc_lr_memo_map__hash(rule) & mask;\n"
+            "    while (map->buf[i].rule != NULL && map->buf[i].rule != rule) i = (i + 1) & mask;\n"
+            "    return i;\n"
             "}\n"
             "\n"
             "static void pcc_lr_memo_map__put(pcc_auxil_t auxil, pcc_lr_memo_map_t *map, pcc_rule_t rule, pcc_lr_answer_t *answer) {\n"
-            "    const size_t i = pcc_lr_memo_map__index(auxil, map, rule);\n"
-            "    if (i != VOID_VALUE) {\n"
+            "    size_t i = pcc_lr_memo_map__index(auxil, map, rule);\n"
+            "    if (map->buf[i].rule != NULL) {\n"
             "        pcc_lr_answer__destroy(auxil, map->buf[i].answer);\n"
             "        map->buf[i].answer = answer;\n"
+            "        return;\n"
             "    }\n"
-            "    else {\n"
-            "        if (map->max <= map->len) {\n"
-            "            const size_t n = map->len + 1;\n"
-            "            size_t m = map->max;\n"
-            "            if (m == 0) m = 1;\n"
-            "            while (m < n && m != 0) m <<= 1;\n"
-            "            if (m == 0) m = n;\n"
-            "            map->buf = (pcc_lr_memo_t *)PCC_REALLOC(auxil, map->buf, sizeof(pcc_lr_memo_t) * m);\n"
-            "            map->max = m;\n"
+            "    if ((map->len + 1) * 2 > map->max) {\n"
+            "        pcc_lr_memo_t *const old = map->buf;\n"
+            "        const size_t n = map->max;\n"
+            "        size_t j;\n"
+            "        map->max <<= 1;\n"
+            "        map->buf = (pcc_lr_memo_t *)PCC_MALLOC(auxil, sizeof(pcc_lr_memo_t) * map->max);\n"
+            "        for (j = 0; j < map->max; j++) map->buf[j].rule = NULL;\n"
+            "        for (j = 0; j < n; j++) {\n"
+            "            if (old[j].rule != NULL) map->buf[pcc_lr_memo_map__index(auxil, map, old[j].rule)] = old[j];\n"
             "        }\n"
-            "        map->buf[map->len].rule = rule;\n"
-            "        map->buf[map->len].answer = answer;\n"
-            "        map->len++;\n"
+            "        PCC_FREE(auxil, old);\n"
+            "        i = pcc_lr_memo_map__index(auxil, map, rule);\n"
             "    }\n"
+            "    map->buf[i].rule = rule;\n"
+            "    map->buf[i].answer = answer;\n"
+            "    map->len++;\n"
             "}\n"
             "\n"
             "static pcc_lr_answer_t *pcc_lr_memo_map__get(pcc_auxil_t auxil, pcc_lr_memo_map_t *map, pcc_rule_t rule) {\n"
             "    const size_t i = pcc_lr_memo_map__index(auxil, map, rule);\n"
-            "    return (i != VOID_VALUE) ? map->buf[i].answer : NULL;\n"
+            "    return (map->buf[i].rule != NULL) ? map->buf[i].answer : NULL;\n"
             "}\n"
             "\n"
-            "static void pcc_lr_memo_map__term(pcc_auxil_t auxil, pcc_lr_memo_map_t *map) {\n"
-            "    while (map->len > 0) {\n"
+            "static void pcc_lr_memo_map__clear(pcc_auxil_t auxil, pcc_lr_memo_map_t *map) {\n"
+            "    size_t i;\n"
+            "    for (i = 0; map->len > 0 && i < map->max; i++) {\n"
+            "        if (map->buf[i].rule == NULL) continue;\n"
+            "        pcc_lr_answer__destroy(auxil, map->buf[i].answer);\n"
+            "        map->buf[i].rule = NULL;\n"
             "        map->len--;\n"
-            "        pcc_lr_answer__destroy(auxil, map->buf[map->len].answer);\n"
             "    }\n"
+            "}\n"
+            "\n"
+            "static void pcc_lr_memo_map__term(pcc_auxil_t auxil, pcc_lr_memo_map_t *map) {\n"
+            "    pcc_lr_memo_map__clear(auxil, map);\n"
             "    PCC_FREE(auxil, map->buf);\n"
             "}\n"
             "\n",
@@ -3851,9 +3877,20 @@ static bool_t generate(context_t *ctx) {
             "    pcc_lr_memo_map__init(auxil, &entry->memos, PCC_ARRAYSIZE);\n"
             "    entry->hold_a = NULL;\n"
             "    entry->hold_h = NULL;\n"
+            "    entry->next = NULL;\n"
             "    return entry;\n"
             "}\n"
             "\n"
+            "/* Releases what the entry holds, keeping the memory of the memo map. */\n"
+            "static void pcc_lr_table_entry__clear(pcc_auxil_t auxil, pcc_lr_table_entry_t *entry) {\n"
+            "    pcc_lr_head__destroy(auxil, entry->hold_h);\n"
+            "    pcc_lr_answer__destroy(auxil, entry->hold_a);\n"
+            "    pcc_lr_memo_map__clear(auxil, &entry->memos);\n"
+            "    entry->head = NULL;\n"
+            "    entry->hold_a = NULL;\n"
+            "    entry->hold_h = NULL;\n"
+            "}\n"
+            "\n"
             "static void pcc_lr_table_entry__destroy(pcc_auxil_t auxil, pcc_lr_table_entry_t *entry) {\n"
             "    if (entry == NULL) return;\n"
             "    pcc_lr_head__destroy(auxil, entry->hold_h);\n"
@@ -3869,11 +3906,32 @@ static bool_t generate(context_t *ctx) {
             "    table->len = 0;\n"
             "    table->max = max;\n"
             "    table->buf = (pcc_lr_table_entry_t **)PCC_MALLOC(auxil, sizeof(pcc_lr_table_entry_t *) * table->max);\n"
+            "    table->free = NULL;\n"
+            "}\n"
+            "\n"
+            "static void pcc_lr_table__release(pcc_auxil_t auxil, pcc_lr_table_t *table, pcc_lr_table_entry_t *entry) {\n"
+            "    if (entry == NULL) return;\n"
+            "    pcc_lr_table_entry__clear(auxil, entry);\n"
+            "    entry->next = table->free;\n"
+            "    table->free = entry;\n"
+            "}\n"
+            "\n"
+            "static pcc_lr_table_entry_t *pcc_lr_table__entry(pcc_auxil_t auxil, pcc_lr_table_t *table, size_t index) {\n"
+            "    if (table->buf[index] == NULL) {\n"
+            "        if (table->free != NULL) {\n"
+            "            table->buf[index] = table->free;\n"
+            "            table->free = table->free->next;\n"
+            "        }\n"
+            "        else {\n"
+            "            table->buf[index] = pcc_lr_table_entry__create(auxil);\n"
+            "        }\n"
+            "    }\n"
+            "    return table->buf[index];\n"
             "}\n"
             "\n"
             "static void pcc_lr_table__resize(pcc_auxil_t auxil, pcc_lr_table_t *table, size_t len) {\n"
             "    size_t i;\n"
-            "    for (i = len; i < table->len; i++) pcc_lr_table_entry__destroy(auxil, table->buf[i]);\n"
+            "    for (i = len; i < table->len; i++) pcc_lr_table__release(auxil, table, table->buf[i]);\n"
             "    if (table->max < len) {\n"
             "        size_t m = table->max;\n"
             "        if (m == 0) m = 1;\n"
@@ -3888,26 +3946,24 @@ static bool_t generate(context_t *ctx) {
             "\n"
             "static void pcc_lr_table__set_head(pcc_auxil_t auxil, pcc_lr_table_t *table, size_t index, pcc_lr_head_t *head) {\n"
             "    if (index >= table->len) pcc_lr_table__resize(auxil, table, index + 1);\n"
-            "    if (table->buf[index] == NULL) table->buf[index] = pcc_lr_table_entry__create(auxil);\n"
-            "    table->buf[index]->head = head;\n"
+            "    pcc_lr_table__entry(auxil, table, index)->head = head;\n"
             "}\n"
             "\n"
             "static void pcc_lr_table__hold_head(pcc_auxil_t auxil, pcc_lr_table_t *table, size_t index, pcc_lr_head_t *head) {\n"
             "    if (index >= table->len) pcc_lr_table__resize(auxil, table, index + 1);\n"
-            "    if (table->buf[index] == NULL) table->buf[index] = pcc_lr_table_entry__create(auxil);\n"
+            "    pcc_lr_table__entry(auxil, table, index);\n"
             "    head->hold = table->buf[index]->hold_h;\n"
             "    table->buf[index]->hold_h = head;\n"
             "}\n"
             "\n"
             "static void pcc_lr_table__set_answer(pcc_auxil_t auxil, pcc_lr_table_t *table, size_t index, pcc_rule_t rule, pcc_lr_answer_t *answer) {\n"
             "    if (index >= table->len) pcc_lr_table__resize(auxil, table, index + 1);\n"
-            "    if (table->buf[index] == NULL) table->buf[index] = pcc_lr_table_entry__create(auxil);\n"
-            "    pcc_lr_memo_map__put(auxil, &table->buf[index]->memos, rule, answer);\n"
+            "    pcc_lr_memo_map__put(auxil, &pcc_lr_table__entry(auxil, table, index)->memos, rule, answer);\n"
             "}\n"
             "\n"
             "static void pcc_lr_table__hold_answer(pcc_auxil_t auxil, pcc_lr_table_t *table, size_t index, pcc_lr_answer_t *answer) {\n"
             "    if (index >= table->len) pcc_lr_table__resize(auxil, table, index + 1);\n"
-            "    if (table->buf[index] == NULL) table->buf[index] = pcc_lr_table_entry__create(auxil);\n"
+            "    pcc_lr_table__entry(auxil, table, index);\n"
             "    answer->hold = table->buf[index]->hold_a;\n"
             "    table->buf[index]->hold_a = answer;\n"
             "}\n"
@@ -3925,7 +3981,7 @@ static bool_t generate(context_t *ctx) {
             "static void pcc_lr_table__shift(pcc_auxil_t auxil, pcc_lr_table_t *table, size_t count) {\n"
             "    size_t i;\n"
             "    if (count > table->len) count = table->len;\n"
-            "    for (i = 0; i < count; i++) pcc_lr_table_entry__destroy(auxil, table->buf[i]);\n"
+            "    for (i = 0; i < count; i++) pcc_lr_table__release(auxil, table, table->buf[i]);\n"
             "    memmove(table->buf, table->buf + count, sizeof(pcc_lr_table_entry_t *) * (table->len - count));\n"
             "    table->len -= count;\n"
             "}\n"
@@ -3935,6 +3991,11 @@ static bool_t generate(context_t *ctx) {
             "        table->len--;\n"
             "        pcc_lr_table_entry__destroy(auxil, table->buf[table->len]);\n"
             "    }\n"
+            "    while (table->free != NULL) {\n"
+            "        pcc_lr_table_entry_t *const entry = table->free;\n"
+            "        table->free = entry->next;\n"
+            "        pcc_lr_table_entry__destroy(auxil, entry);\n"
+            "    }\n"
             "    PCC_FREE(auxil, table->buf);\n"
             "}\n"
             "\n",
@@ -4134,10 +4195,10 @@ static bool_t generate(context_t *ctx) {
         fputs_e(
             "    static pcc_value_t null;\n"
             "    pcc_thunk_chunk_t *c = NULL;\n"
-            "    const size_t p = ctx->pos + ctx->cur;\n"
+            "    const size_t p = ctx->pos + ctx->cur; /* the memo table is indexed by p - ctx->pos */\n"
             "    pcc_bool_t b = PCC_TRUE;\n"
-            "    pcc_lr_answer_t *a = pcc_lr_table__get_answer(ctx->auxil, &ctx->lrtable, p, rule);\n"
-            "    pcc_lr_head_t *h = pcc_lr_table__get_head(ctx->auxil, &ctx->lrtable, p);\n"
+            "    pcc_lr_answer_t *a = pcc_lr_table__get_answer(ctx->auxil, &ctx->lrtable, p - ctx->pos, rule);\n"
+            "    pcc_lr_head_t *h = pcc_lr_table__get_head(ctx->auxil, &ctx->lrtable, p - ctx->pos);\n"
             "    if (h != NULL) {\n"
             "        if (a == NULL && rule != h->rule && pcc_rule_set__index(ctx->auxil, &h->invol, rule) == VOID_VALUE) {\n"
             "            b = PCC_FALSE;\n"
@@ -4148,7 +4209,7 @@ static bool_t generate(context_t *ctx) {
             "            c = rule(ctx);\n"
             "            a = pcc_lr_answer__create(ctx->auxil, PCC_LR_ANSWER_CHUNK, ctx->pos + ctx->cur);\n"
             "            a->data.chunk = c;\n"
-            "            pcc_lr_table__hold_answer(ctx->auxil, &ctx->lrtable, p, a);\n"
+            "            pcc_lr_table__hold_answer(ctx->auxil, &ctx->lrtable, p - ctx->pos, a);\n"
             "        }\n"
             "    }\n"
             "    if (b) {\n"
@@ -4158,7 +4219,7 @@ static bool_t generate(context_t *ctx) {
             "            case PCC_LR_ANSWER_LR:\n"
             "                if (a->data.lr->head == NULL) {\n"
             "                    a->data.lr->head = pcc_lr_head__create(ctx->auxil, rule);\n"
-            "                    pcc_lr_table__hold_head(ctx->auxil, &ctx->lrtable, p, a->data.lr->head);\n"
+            "                    pcc_lr_table__hold_head(ctx->auxil, &ctx->lrtable, p - ctx->pos, a->data.lr->head);\n"
             "                }\n"
             "                {\n"
             "                    size_t i = ctx->lrstack.len;\n"
@@ -4183,7 +4244,7 @@ static bool_t generate(context_t *ctx) {
             "            pcc_lr_stack__push(ctx->auxil, &ctx->lrstack, e);\n"
             "            a = pcc_lr_answer__create(ctx->auxil, PCC_LR_ANSWER_LR, p);\n"
             "            a->data.lr = e;\n"
-            "            pcc_lr_table__set_answer(ctx->auxil, &ctx->lrtable, p, rule, a);\n"
+            "            pcc_lr_table__set_answer(ctx->auxil, &ctx->lrtable, p - ctx->pos, rule, a);\n"
             "            c = rule(ctx);\n"
             "            pcc_lr_stack__pop(ctx->auxil, &ctx->lrstack);\n"
             "            a->pos = ctx->pos + ctx->cur;\n"
@@ -4197,7 +4258,7 @@ static bool_t generate(context_t *ctx) {
             "                    c = a->data.lr->seed;\n"
             "                    a = pcc_lr_answer__create(ctx->auxil, PCC_LR_ANSWER_CHUNK, ctx->pos + ctx->cur);\n"
             "                    a->data.chunk = c;\n"
-            "                    pcc_lr_table__hold_answer(ctx->auxil, &ctx->lrtable, p, a);\n"
+            "                    pcc_lr_table__hold_answer(ctx->auxil, &ctx->lrtable, p - ctx->pos, a);\n"
             "                }\n"
             "                else {\n"
             "                    pcc_lr_answer__set_chunk(ctx->auxil, a, a->data.lr->seed);\n"
@@ -4205,7 +4266,7 @@ static bool_t generate(context_t *ctx) {
             "                        c = NULL;\n"
             "                    }\n"
             "                    else {\n"
-            "                        pcc_lr_table__set_head(ctx->auxil, &ctx->lrtable, p, h);\n"
+            "                        pcc_lr_table__set_head(ctx->auxil, &ctx->lrtable, p - ctx->pos, h);\n"
             "                        for (;;) {\n"
             "                            ctx->cur = p - ctx->pos;\n"
             "                            pcc_rule_set__copy(ctx->auxil, &h->eval, &h->invol);\n"
@@ -4215,7 +4276,7 @@ static bool_t generate(context_t *ctx) {
             "                            a->pos = ctx->pos + ctx->cur;\n"
             "                        }\n"
             "                        pcc_thunk_chunk__destroy(ctx->auxil, c);\n"
-            "                        pcc_lr_table__set_head(ctx->auxil, &ctx->lrtable, p, NULL);\n"
+            "                        pcc_lr_table__set_head(ctx->auxil, &ctx->lrtable, p - ctx->pos, NULL);\n"
             "                        ctx->cur = a->pos - ctx->pos;\n"
             "                        c = a->data.chunk;\n"
             "                    }\n"
@@ -4303,8 +4364,8 @@ static bool_t generate(context_t *ctx) {
                     }
                     fputs_e(
                         "#define _0 pcc_get_capture_string(__pcc_ctx, &__pcc_in->data.leaf.capt0)\n"
-                        "#define _0s ((const size_t)__pcc_in->data.leaf.capt0.range.start)\n"
-                        "#define _0e ((const size_t)__pcc_in->data.leaf.capt0.range.end)\n",
+                        "#define _0s ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capt0.range.start))\n"
+                        "#define _0e ((const size_t)(__pcc_ctx->pos + __pcc_in->data.leaf.capt0.range.end))\n",
                         sstream
                     );
                     k = 0;
@@ -44,6 +44,7 @@ enum ansiblePlaybookPlayDetectingState {
 struct sAnsiblePlaybookSubparser {
 	yamlSubparser yaml;
 	struct yamlBlockTypeStack *type_stack;
+	struct yamlBlockTypeStack *free_stack;
 	enum ansiblePlaybookPlayDetectingState play_detection_state;
 };
 
@@ -51,7 +52,13 @@ static void pushBlockType (struct sAnsiblePlaybookSubparser *ansible, yaml_token
 {
 	struct yamlBlockTypeStack *s;
 
-	s = xMalloc (1, struct yamlBlockTypeStack);
+	if (ansible->free_stack)
+	{
+		s = ansible->free_stack;
+		ansible->free_stack = s->next;
+	}
+	else
+		s = xMalloc (1, struct yamlBlockTypeStack);
 
 	s->next = ansible->type_stack;
 	ansible->type_stack = s;
@@ -68,12 +75,12 @@ static void popBlockType (struct sAnsiblePlaybookSubparser *ansible,
 	s = ansible->type_stack;
 	ansible->type_stack = s->next;
 
-	s->next = NULL;
 	tagEntryInfo *tag = getEntryInCorkQueue (s->associatedCorkIndex);
 	if (tag)
 		attachYamlPosition (tag, token, true);
 
-	eFree (s);
+	s->next = ansible->free_stack;
+	ansible->free_stack = s;
 }
 
 static void popAllBlockType (struct sAnsiblePlaybookSubparser *ansible,
@@ -182,11 +189,21 @@ static void inputStart(subparser *s)
 {
 	((struct sAnsiblePlaybookSubparser*)s)->play_detection_state = DSTAT_PLAY_NAME_INITIAL;
 	((struct sAnsiblePlaybookSubparser*)s)->type_stack = NULL;
+	((struct sAnsiblePlaybookSubparser*)s)->free_stack = NULL;
 }
 
 static void inputEnd(subparser *s)
 {
-	Assert (((struct sAnsiblePlaybookSubparser*)s)->type_stack == NULL);
+	struct sAnsiblePlaybookSubparser *ansible = (struct sAnsiblePlaybookSubparser*)s;
+
+	Assert (ansible->type_stack == NULL);
+
+	while (ansible->free_stack)
+	{
+		struct yamlBlockTypeStack *next = ansible->free_stack->next;
+		eFree (ansible->free_stack);
+		ansible->free_stack = next;
+	}
 }
 
 static void
@@ -204,6 +221,13 @@ extern parserDefinition* AnsiblePlaybookParser (void)
 				.inputStart = inputStart,
 				.inputEnd = inputEnd,
 			},
+			/* Stream and document level tokens are always preceded by
+			 * block ends, which already reset the state machine. */
+			.tokenTypes = ~(YAML_TOKEN_TYPE_BIT (YAML_STREAM_START_TOKEN)
+							| YAML_TOKEN_TYPE_BIT (YAML_VERSION_DIRECTIVE_TOKEN)
+							| YAML_TOKEN_TYPE_BIT (YAML_TAG_DIRECTIVE_TOKEN)
+							| YAML_TOKEN_TYPE_BIT (YAML_DOCUMENT_START_TOKEN)
+							| YAML_TOKEN_TYPE_BIT (YAML_DOCUMENT_END_TOKEN)),
 			.newTokenNotfify = newTokenCallback
 		},
 	};
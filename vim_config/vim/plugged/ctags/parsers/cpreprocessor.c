@@ -80,6 +80,7 @@ typedef struct sCppState {
 	vString * charOrStringContents;
 
 	bool resolveRequired;     /* must resolve if/else/elif/endif branch */
+	bool branchIgnored;       /* some conditional branch has been ignored */
 	bool hasAtLiteralStrings; /* supports @"c:\" strings */
 	bool hasCxxRawLiteralStrings; /* supports R"xxx(...)xxx" strings */
 	bool hasSingleQuoteLiteralNumbers; /* supports vera number literals:
@@ -195,6 +196,7 @@ static cppState Cpp = {
 	.ungetDataSize = 0,
 	.charOrStringContents = NULL,
 	.resolveRequired = false,
+	.branchIgnored = false,
 	.hasAtLiteralStrings = false,
 	.hasCxxRawLiteralStrings = false,
 	.hasSingleQuoteLiteralNumbers = false,
@@ -245,6 +247,15 @@ extern unsigned int cppGetDirectiveNestLevel (void)
 	return Cpp.directive.nestLevel;
 }
 
+/* Tells whether the code in some conditional branch was not passed to
+ * the client parser since the last cppInit().  If none was, a rescan
+ * in brace format would see exactly the same input again.
+ * This remains valid after cppTerminate(). */
+extern bool cppHasIgnoredBranch (void)
+{
+	return Cpp.branchIgnored;
+}
+
 static void cppInitCommon(langType clientLang,
 		     const bool state, const bool hasAtLiteralStrings,
 		     const bool hasCxxRawLiteralStrings,
@@ -278,6 +289,7 @@ static void cppInitCommon(langType clientLang,
 	Cpp.charOrStringContents = vStringNew();
 
 	Cpp.resolveRequired = false;
+	Cpp.branchIgnored = false;
 	Cpp.hasAtLiteralStrings = hasAtLiteralStrings;
 	Cpp.hasCxxRawLiteralStrings = hasCxxRawLiteralStrings;
 	Cpp.hasSingleQuoteLiteralNumbers = hasSingleQuoteLiteralNumbers;
@@ -623,6 +635,8 @@ static bool isIgnore (void)
 
 static bool setIgnore (const bool ignore)
 {
+	if (ignore)
+		Cpp.branchIgnored = true;
 	return Cpp.directive.ifdef [Cpp.directive.nestLevel].ignoring = ignore;
 }
 
@@ -717,6 +731,8 @@ static bool pushConditional (const bool firstBranchChosen)
 				(ifdef->singleBranch || !doesExaminCodeWithInIf0Branch)));
 		ifdef->enterExternalParserBlockNestLevel = externalParserBlockNestLevel;
 		ignoreBranch = ifdef->ignoring;
+		if (ignoreBranch)
+			Cpp.branchIgnored = true;
 	}
 	return ignoreBranch;
 }
@@ -73,6 +73,7 @@
 */
 extern bool cppIsBraceFormat (void);
 extern unsigned int cppGetDirectiveNestLevel (void);
+extern bool cppHasIgnoredBranch (void);
 
 /* Don't forget to set useCort true in your parser.
  * The corkQueue is needed to capture macro parameters.
@@ -1271,7 +1271,10 @@ static bool cxxParserParseClassStructOrUnionInternal(
 		if (bAnonymous)
 			markTagExtraBit (tag, XTAG_ANONYMOUS);
 
-		if(g_cxx.pTokenChain->iCount > 0)
+		if(
+				(g_cxx.pTokenChain->iCount > 0) &&
+				cxxTagCoreFieldEnabled(CXXTagCoreFieldInheritance)
+			)
 		{
 			// Strip inheritance type information
 			// FIXME: This could be optional!
@@ -1883,7 +1886,10 @@ static rescanReason cxxParserMain(const unsigned int passCount)
 		cxxTokenChainClear(g_cxx.pTemplateSpecializationTokenChain);
 	// Restart coveralls: LCOV_EXCL_END
 
-	if(!bRet && (passCount == 1))
+	// The second pass differs from the first one only in the conditional
+	// branches the preprocessor lets through: if none was ignored, it would
+	// see the same input and fail in the same place.
+	if(!bRet && (passCount == 1) && cppHasIgnoredBranch())
 	{
 		CXX_DEBUG_PRINT("Processing failed: trying to rescan");
 		return RESCAN_FAILED;
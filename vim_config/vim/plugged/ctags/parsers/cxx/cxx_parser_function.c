@@ -294,7 +294,8 @@ int cxxParserMaybeParseKnRStyleFunctionDefinition(void)
 		tag->isFileScope = (g_cxx.uKeywordState & CXXParserKeywordStateSeenStatic) &&
 				!isInputHeaderFile();
 
-		vString * pszSignature = cxxTokenChainJoin(pParenthesis->pChain,NULL,0);
+		vString * pszSignature = cxxTagCoreFieldEnabled(CXXTagCoreFieldSignature) ?
+				cxxTokenChainJoin(pParenthesis->pChain,NULL,0) : NULL;
 
 		// FIXME: Return type!
 		// FIXME: Properties?
@@ -1572,8 +1573,10 @@ int cxxParserEmitFunctionTags(
 			}
 		}
 
-		vString * pszSignature = cxxTokenChainJoin(pInfo->pParenthesis->pChain,NULL,0);
-		if(pInfo->pSignatureConst)
+		vString * pszSignature = NULL;
+		if(cxxTagCoreFieldEnabled(CXXTagCoreFieldSignature))
+			pszSignature = cxxTokenChainJoin(pInfo->pParenthesis->pChain,NULL,0);
+		if(pszSignature && pInfo->pSignatureConst)
 		{
 			vStringPut (pszSignature, ' ');
 			cxxTokenAppendToString(pszSignature,pInfo->pSignatureConst);
@@ -1833,6 +1836,7 @@ void cxxParserEmitFunctionParameterTags(CXXTypedVariableSet * pInfo)
 			break;
 
 		CXXToken * pTypeName;
+		bool bIdentifierTaken = false;
 
 		if(pInfo->aTypeStarts[i] && pInfo->aTypeEnds[i])
 		{
@@ -1855,7 +1859,10 @@ void cxxParserEmitFunctionParameterTags(CXXTypedVariableSet * pInfo)
 				else if(pTypeEnd == pInfo->aIdentifiers[i])
 					pTypeEnd = pTypeEnd->pPrev;
 
-				cxxTokenChainTakeRecursive(pInfo->pChain,pInfo->aIdentifiers[i]);
+				bIdentifierTaken = cxxTokenChainTakeRecursive(
+						pInfo->pChain,
+						pInfo->aIdentifiers[i]
+					);
 
 				pTypeName = cxxTagCheckAndSetTypeField(
 						pTypeStart,
@@ -1877,11 +1884,10 @@ void cxxParserEmitFunctionParameterTags(CXXTypedVariableSet * pInfo)
 
 		cxxTagCommit();
 
-		if(pTypeName)
-		{
+		if(bIdentifierTaken)
 			cxxTokenDestroy(pInfo->aIdentifiers[i]);
+		if(pTypeName)
 			cxxTokenDestroy(pTypeName);
-		}
 
 		i++;
 	}
@@ -310,6 +310,11 @@ typedef struct _CXXParserState
 	fieldDefinition * pFieldOptions;
 	// The number of field options, used mainly for checking/debug purposes
 	unsigned int uFieldOptionCount;
+	// The bit mask of the fields above that are printed, indexed by
+	// the field number. Computed once per file by cxxTagInitForLanguage().
+	unsigned int uRenderedFields;
+	// The CXXTagCoreField mask of core fields that are printed.
+	unsigned int uRenderedCoreFields;
 
 	// The current token chain
 	CXXTokenChain * pTokenChain;
@@ -260,7 +260,10 @@ bool cxxParserHandleLambda(CXXToken * pParenthesis)
 		// FIXME: Properties?
 
 		vString * pszSignature = NULL;
-		if(cxxTokenTypeIs(pParenthesis,CXXTokenTypeParenthesisChain))
+		if(
+				cxxTokenTypeIs(pParenthesis,CXXTokenTypeParenthesisChain) &&
+				cxxTagCoreFieldEnabled(CXXTagCoreFieldSignature)
+			)
 			pszSignature = cxxTokenChainJoin(pParenthesis->pChain,NULL,0);
 
 		if(pszSignature)
@@ -161,6 +161,26 @@ void cxxTagInitForLanguage(langType eLangType)
 	} else {
 		CXX_DEBUG_ASSERT(false,"Invalid language passed to cxxTagInitForLanguage()");
 	}
+
+	CXX_DEBUG_ASSERT(
+			g_cxx.uFieldOptionCount <= sizeof(g_cxx.uRenderedFields) * 8,
+			"Too many fields for the rendered field mask"
+		);
+
+	g_cxx.uRenderedFields = 0;
+	for(unsigned int i = 0;i < g_cxx.uFieldOptionCount;i++)
+	{
+		if(isFieldRendered(g_cxx.pFieldOptions[i].ftype))
+			g_cxx.uRenderedFields |= (1u << i);
+	}
+
+	g_cxx.uRenderedCoreFields = 0;
+	if(isFieldRendered(FIELD_SIGNATURE))
+		g_cxx.uRenderedCoreFields |= CXXTagCoreFieldSignature;
+	if(isFieldRendered(FIELD_TYPE_REF))
+		g_cxx.uRenderedCoreFields |= CXXTagCoreFieldTypeRef;
+	if(isFieldRendered(FIELD_INHERITANCE))
+		g_cxx.uRenderedCoreFields |= CXXTagCoreFieldInheritance;
 }
 
 kindDefinition * cxxTagGetCKindDefinitions(void)
@@ -238,7 +258,12 @@ bool cxxTagFieldEnabled(unsigned int uField)
 			uField < g_cxx.uFieldOptionCount,
 			"The field must be associated to the current language!"
 		);
-	return g_cxx.pFieldOptions[uField].enabled;
+	return (g_cxx.uRenderedFields & (1u << uField)) != 0;
+}
+
+bool cxxTagCoreFieldEnabled(unsigned int uCoreField)
+{
+	return (g_cxx.uRenderedCoreFields & uCoreField) != 0;
 }
 
 
@@ -448,6 +473,9 @@ CXXToken * cxxTagCheckAndSetTypeField(
 	//        and we are pushing it way beyond them.
 	//        We should have a plain "type" field instead.
 
+	if(!cxxTagCoreFieldEnabled(CXXTagCoreFieldTypeRef))
+		return NULL;
+
 	static const char * szTypename = "typename";
 	static const char * szMeta = "meta"; // for type template arguments
 
@@ -525,7 +553,7 @@ void cxxTagSetField(unsigned int uField,const char * szValue,bool bCopyValue)
 			"The field must be associated to the current language!"
 		);
 
-	if(!g_cxx.pFieldOptions[uField].enabled)
+	if(!cxxTagFieldEnabled(uField))
 		return;
 
 	/* If we make a copy for the value, the copy must be freed after
@@ -546,7 +574,7 @@ void cxxTagSetCorkQueueField(
 			"The field must be associated to the current language!"
 		);
 
-	CXX_DEBUG_ASSERT(g_cxx.pFieldOptions[uField].enabled,"The field must be enabled!");
+	CXX_DEBUG_ASSERT(cxxTagFieldEnabled(uField),"The field must be enabled!");
 
 	attachParserFieldToCorkEntry(iIndex,g_cxx.pFieldOptions[uField].ftype,szValue);
 }
@@ -78,8 +78,22 @@ int cxxTagGetCUDAFieldDefinitionifierCount(void);
 fieldDefinition * cxxTagGetCFieldDefinitionifiers(void);
 int cxxTagGetCFieldDefinitionifierCount(void);
 
+// Returns true if the specified field of the current language is enabled
+// and printed by the current writer.
 bool cxxTagFieldEnabled(unsigned int uField);
 
+// The fields of the ctags core that this parser builds from token chains.
+typedef enum _CXXTagCoreField
+{
+	CXXTagCoreFieldSignature = 1,
+	CXXTagCoreFieldTypeRef = (1 << 1),
+	CXXTagCoreFieldInheritance = (1 << 2)
+} CXXTagCoreField;
+
+// Returns true if the specified core field is printed by the current writer.
+// Building the value of a field that is not printed is a waste of time.
+bool cxxTagCoreFieldEnabled(unsigned int uCoreField);
+
 kindDefinition * cxxTagGetCKindDefinitions(void);
 int cxxTagGetCKindDefinitionCount(void);
 
@@ -22,6 +22,7 @@
 #include "debug.h"
 #include "entry.h"
 #include "keyword.h"
+#include "objpool.h"
 #include "parse.h"
 #include "read.h"
 #include "routines.h"
@@ -45,6 +46,8 @@
  */
 #define isType(token,t)		(bool) ((token)->type == (t))
 #define isKeyword(token,k)	(bool) ((token)->keyword == (k))
+#define newToken() (objPoolGet (TokenPool))
+#define deleteToken(t) (objPoolPut (TokenPool, (t)))
 #define isReservedWord(token) (SqlReservedWord[(token)->keyword].fn \
 							   ?(bool)SqlReservedWord[(token)->keyword].fn(token) \
 							   :SqlReservedWord[(token)->keyword].bit)
@@ -210,6 +213,8 @@ typedef struct sTokenInfoSQL {
 
 static langType Lang_sql;
 
+static objPool *TokenPool = NULL;
+
 typedef enum {
 	SQLTAG_CURSOR,
 	SQLTAG_PROTOTYPE,
@@ -563,25 +568,35 @@ static bool isMatchedEnd(tokenInfo *const token, int nest_lvl)
 	return terminated;
 }
 
-static tokenInfo *newToken (void)
+static void *newPoolToken (void *createArg CTAGS_ATTR_UNUSED)
 {
 	tokenInfo *const token = xMalloc (1, tokenInfo);
 
-	token->type               = TOKEN_UNDEFINED;
-	token->keyword            = KEYWORD_NONE;
 	token->string             = vStringNew ();
 	token->scope              = vStringNew ();
+
+	return token;
+}
+
+static void clearPoolToken (void *data)
+{
+	tokenInfo *const token = data;
+
+	token->type               = TOKEN_UNDEFINED;
+	token->keyword            = KEYWORD_NONE;
+	vStringClear (token->string);
+	vStringClear (token->scope);
 	token->scopeKind          = SQLTAG_COUNT;
 	token->begin_end_nest_lvl = 0;
 	token->lineNumber         = getInputLineNumber ();
 	token->filePosition       = getInputFilePosition ();
 	token->promise            = -1;
-
-	return token;
 }
 
-static void deleteToken (tokenInfo *const token)
+static void deletePoolToken (void *data)
 {
+	tokenInfo *const token = data;
+
 	vStringDelete (token->string);
 	vStringDelete (token->scope);
 	eFree (token);
@@ -2981,6 +2996,16 @@ static void initialize (const langType language)
 	Assert (ARRAY_SIZE (SqlKinds) == SQLTAG_COUNT);
 	Lang_sql = language;
 	addKeywordGroup (&predefinedInquiryDirective, language);
+
+	TokenPool = objPoolNew (16, newPoolToken, deletePoolToken, clearPoolToken, NULL);
+}
+
+static void finalize (langType language CTAGS_ATTR_UNUSED, bool initialized)
+{
+	if (!initialized)
+		return;
+
+	objPoolDelete (TokenPool);
 }
 
 static void findSqlTags (void)
@@ -3003,6 +3028,7 @@ extern parserDefinition* SqlParser (void)
 	def->aliases    = aliases;
 	def->parser		= findSqlTags;
 	def->initialize = initialize;
+	def->finalize   = finalize;
 	def->keywordTable = SqlKeywordTable;
 	def->keywordCount = ARRAY_SIZE (SqlKeywordTable);
 	def->useCork = CORK_QUEUE | CORK_SYMTAB;
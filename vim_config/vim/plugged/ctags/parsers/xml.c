@@ -145,13 +145,10 @@ static int makeNsPrefixTag (const char *name, xmlNode *node, xmlNsPtr ns)
 	 * - adjust the line number for nsprefixes forward. */
 	tag.lineNumber = XML_GET_LINE (node);
 	tag.filePosition = getInputFilePositionForLine (tag.lineNumber);
-	char *p = (char *)xmlGetNodePath (node);
 	if (ns->href && *ns->href)
 		attachParserField (&tag, false, XmlFields [F_NS_URI].ftype, (char *)ns->href);
 
 	n = makeTagWithNotificationCommon (&tag, node);
-	if (p)
-		xmlFree (p);
 	if (anon)
 		vStringDelete (anon);
 
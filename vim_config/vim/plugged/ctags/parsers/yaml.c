@@ -120,12 +120,19 @@ static void handlYamlToken (yaml_token_t *token)
 
 }
 
+static unsigned int subparserTokenTypes (subparser *sub)
+{
+	unsigned int types = ((yamlSubparser *)sub)->tokenTypes;
+	return types? types: ~0U;
+}
+
 static void findYamlTags (void)
 {
 	subparser *sub;
 	yaml_parser_t yaml;
 	yaml_token_t token;
 	bool done;
+	unsigned int wanted = 0;
 
 	yamlInit (&yaml);
 
@@ -135,6 +142,9 @@ static void findYamlTags (void)
 	if (sub)
 		chooseExclusiveSubparser (sub, NULL);
 
+	foreachSubparser(sub, false)
+		wanted |= subparserTokenTypes (sub);
+
 	done = false;
 	while (!done)
 	{
@@ -142,11 +152,16 @@ static void findYamlTags (void)
 			break;
 
 		handlYamlToken (&token);
-		foreachSubparser(sub, false)
+		if (wanted & YAML_TOKEN_TYPE_BIT (token.type))
 		{
-			enterSubparser (sub);
-			((yamlSubparser *)sub)->newTokenNotfify ((yamlSubparser *)sub, &token);
-			leaveSubparser ();
+			foreachSubparser(sub, false)
+			{
+				if (!(subparserTokenTypes (sub) & YAML_TOKEN_TYPE_BIT (token.type)))
+					continue;
+				enterSubparser (sub);
+				((yamlSubparser *)sub)->newTokenNotfify ((yamlSubparser *)sub, &token);
+				leaveSubparser ();
+			}
 		}
 
 		TRACE_PRINT("yaml token:%s<%d>@Line:%"PRIuPTR"", tokenTypeName[token.type], token.type,
@@ -21,9 +21,14 @@
 #define yaml_token_t void
 #endif
 
+#define YAML_TOKEN_TYPE_BIT(T) (1U << (T))
+
 typedef struct sYamlSubparser yamlSubparser;
 struct sYamlSubparser {
 	subparser subparser;
+	/* Union of YAML_TOKEN_TYPE_BIT () for the token types
+	 * newTokenNotfify wants to see; 0 means all types. */
+	unsigned int tokenTypes;
 	void (* newTokenNotfify) (yamlSubparser *s, yaml_token_t *token);
 };
 
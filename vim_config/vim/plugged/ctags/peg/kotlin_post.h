@@ -18,6 +18,12 @@
 */
 static int getcFromKotlinFile(struct parserCtx *auxil)
 {
+    if (!auxil->start_of_file_sent)
+    {
+        auxil->start_of_file_sent = true;
+        return KOTLIN_START_OF_FILE;
+    }
+
     int c = getcFromInputFile();
     if (auxil->parenthesis_level > 0 && (c == '\r' || c == '\n'))
     {
@@ -27,6 +33,12 @@ static int getcFromKotlinFile(struct parserCtx *auxil)
 }
 
 
+/* Offsets given by the parser count KOTLIN_START_OF_FILE. */
+static long inputOffset (long offset)
+{
+    return offset - 1;
+}
+
 static void pushKind (struct parserCtx *auxil, int kind)
 {
     intArrayAdd (auxil->kind_stack, kind);
@@ -77,7 +89,7 @@ static void makeKotlinTag (struct parserCtx *auxil, const char *name, long offse
         initTagEntry(&e, stripped, k);
         eFree(stripped);
     }
-    e.lineNumber = getInputLineNumberForFileOffset (offset);
+    e.lineNumber = getInputLineNumberForFileOffset (inputOffset (offset));
     e.filePosition = getInputFilePositionForLine (e.lineNumber);
     e.extensionFields.scopeIndex = auxil->scope_cork_index;
     int scope_index = makeTagEntry (&e);
@@ -100,8 +112,8 @@ static void resetFailure(struct parserCtx *auxil, long offset)
 {
     if(auxil->fail_offset >= 0)
     {
-        unsigned long startLine = getInputLineNumberForFileOffset(auxil->fail_offset);
-        unsigned long endLine = getInputLineNumberForFileOffset(offset-1);
+        unsigned long startLine = getInputLineNumberForFileOffset(inputOffset(auxil->fail_offset));
+        unsigned long endLine = getInputLineNumberForFileOffset(inputOffset(offset-1));
         if (startLine == endLine)
         {
             TRACE_PRINT("Failed to parse '%s' at line %lu!\n", getInputFileName(), startLine);
@@ -121,6 +133,7 @@ static void ctxInit (struct parserCtx *auxil)
     auxil->scope_cork_index = CORK_NIL;
     auxil->found_syntax_error = false;
     auxil->parenthesis_level = 0;
+    auxil->start_of_file_sent = false;
     #ifdef DEBUG
     auxil->fail_offset = -1;
     #endif
@@ -24,6 +24,11 @@
 #undef PCC_GETCHAR
 #define PCC_GETCHAR(auxil) getcFromKotlinFile(auxil)
 
+/* getcFromKotlinFile() returns this byte (SOH) once before the input so
+ * that the start rule can tell the first part of the file from the
+ * others. Kotlin source has no use for the control character. */
+#define KOTLIN_START_OF_FILE 0x01
+
 /*
 *   DATA DECLARATIONS
 */
@@ -55,6 +60,7 @@ struct parserCtx {
     intArray *kind_stack;
     bool found_syntax_error;
     int parenthesis_level;
+    bool start_of_file_sent;
     #ifdef DEBUG
     long fail_offset;
     #endif
@@ -141,6 +141,7 @@ LIB_SRCS =			\
 	main/writer.c			\
 	main/writer-etags.c		\
 	main/writer-ctags.c		\
+	main/writer-binary.c		\
 	main/writer-json.c		\
 	main/writer-xref.c		\
 	main/xtag.c			\